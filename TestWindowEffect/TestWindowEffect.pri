@@ -0,0 +1,74 @@
+# Sources shared by the application and the tests in tests/
+
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets concurrent
+
+INCLUDEPATH += $$PWD
+
+SOURCES += \
+    $$PWD/sliderwidget.cpp \
+    $$PWD/customwindow.cpp \
+    $$PWD/inputtrace.cpp \
+    $$PWD/windowsession.cpp \
+    $$PWD/windowshapehints.cpp \
+    $$PWD/wakeupcounter.cpp \
+    $$PWD/togglestatequeue.cpp \
+    $$PWD/resizesnapshot.cpp
+
+HEADERS  += \
+    $$PWD/sliderwidget.h \
+    $$PWD/customwindow.h \
+    $$PWD/inputtrace.h \
+    $$PWD/windowsession.h \
+    $$PWD/windowshapehints.h \
+    $$PWD/wakeupcounter.h \
+    $$PWD/togglestatequeue.h \
+    $$PWD/slidertext.h \
+    $$PWD/resizesnapshot.h
+
+# Warns about heap allocations in steady state SliderWidget frames, replaces the global operator new
+# and, with glibc, malloc, calloc, realloc and free
+alloc_counter {
+    DEFINES += SLIDER_ALLOCATION_COUNTER
+    SOURCES += $$PWD/allocationcounter.cpp
+    HEADERS += $$PWD/allocationcounter.h
+}
+
+# Opaque region and input shape hints for the compositor, X11 only
+unix:!macx:qtHaveModule(x11extras) {
+    QT += x11extras
+    LIBS += -lxcb -lxcb-shape
+    DEFINES += HAVE_X11_SHAPE_HINTS
+}
+
+FORMS    += \
+    $$PWD/customwindow.ui
+
+RESOURCES += \
+    $$PWD/resources.qrc
+
+# The embedded font is subset to the glyphs drawn by SliderWidget when pyftsubset (fonttools)
+# is available. Build with CONFIG+=no_font_subset to embed the full font.
+# The texts are read from slidertext.h, which SliderWidget also uses.
+FONT_TEXTS = $$PWD/slidertext.h
+
+!no_font_subset:system(pyftsubset --help > $$QMAKE_SYSTEM_NULL_DEVICE 2>&1) {
+    FONT_QRC = "<RCC><qresource prefix='/font'>" \
+               "<file alias='AlternateGotNo3D.ttf'>AlternateGotNo3D.subset.ttf</file>" \
+               "</qresource></RCC>"
+    write_file($$OUT_PWD/fonts_subset.qrc, FONT_QRC)
+
+    # subsets and compiles the resource in one step, so a change of the font or texts rebuilds both
+    FONT_SOURCES = $$PWD/font/AlternateGotNo3D.ttf
+    fontsubset.input = FONT_SOURCES
+    fontsubset.output = qrc_fonts_subset.cpp
+    fontsubset.depends = $$FONT_TEXTS
+    fontsubset.commands = pyftsubset ${QMAKE_FILE_IN} --text-file=$$shell_path($$FONT_TEXTS) \
+                          --output-file=$$OUT_PWD/AlternateGotNo3D.subset.ttf && \
+                          $$[QT_HOST_BINS]/rcc -name fonts_subset $$OUT_PWD/fonts_subset.qrc -o ${QMAKE_FILE_OUT}
+    fontsubset.variable_out = SOURCES
+    QMAKE_EXTRA_COMPILERS += fontsubset
+    QMAKE_CLEAN += $$OUT_PWD/AlternateGotNo3D.subset.ttf
+} else {
+    !no_font_subset: warning("pyftsubset not found, embedding the full font")
+    RESOURCES += $$PWD/fonts.qrc
+}
@@ -6,24 +6,11 @@
 
 QT       += core gui
 
-greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
-
 TARGET = TestWindowEffect
 TEMPLATE = app
 
+include(TestWindowEffect.pri)
 
-SOURCES += main.cpp\
-    sliderwidget.cpp \
-    customwindow.cpp
-
-HEADERS  += \
-    sliderwidget.h \
-    customwindow.h
-
-FORMS    += \
-    customwindow.ui
-
-RESOURCES += \
-    resources.qrc
+SOURCES += main.cpp
 
 OTHER_FILES +=
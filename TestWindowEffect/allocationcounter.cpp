@@ -0,0 +1,96 @@
+#include "allocationcounter.h"
+
+#include <cstdlib>
+#include <new>
+
+// per thread, so the pre-render worker does not show up in the GUI thread counts
+static thread_local quint64 allocations = 0;
+
+quint64 allocationCount()
+{
+    return allocations;
+}
+
+#ifdef __GLIBC__
+// Qt containers and strings allocate with malloc and realloc, not operator new, so the C allocator
+// is counted too. operator new calls malloc and is counted there.
+extern "C" void *__libc_malloc(std::size_t size);
+extern "C" void *__libc_calloc(std::size_t count, std::size_t size);
+extern "C" void *__libc_realloc(void *p, std::size_t size);
+extern "C" void __libc_free(void *p);
+
+extern "C" void *malloc(std::size_t size)
+{
+    ++allocations;
+    return __libc_malloc(size);
+}
+
+extern "C" void *calloc(std::size_t count, std::size_t size)
+{
+    ++allocations;
+    return __libc_calloc(count, size);
+}
+
+extern "C" void *realloc(void *p, std::size_t size)
+{
+    if (size)
+        ++allocations;
+    return __libc_realloc(p, size);
+}
+
+extern "C" void free(void *p)
+{
+    __libc_free(p);
+}
+
+#define COUNT_OPERATOR_NEW
+#else
+#define COUNT_OPERATOR_NEW ++allocations;
+#endif
+
+void *operator new(std::size_t size)
+{
+    COUNT_OPERATOR_NEW
+
+    if (void *p = std::malloc(size ? size : 1))
+        return p;
+
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+    COUNT_OPERATOR_NEW
+    return std::malloc(size ? size : 1);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+    COUNT_OPERATOR_NEW
+    return std::malloc(size ? size : 1);
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void *p, std::size_t) noexcept
+{
+    std::free(p);
+}
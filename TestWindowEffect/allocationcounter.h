@@ -0,0 +1,13 @@
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+#include <QtGlobal>
+
+/**
+ * @brief allocationCount Returns the number of heap allocations made by the calling thread: malloc,
+ * calloc, realloc and operator new with glibc, only operator new elsewhere. Only built with
+ * CONFIG+=alloc_counter, which replaces the global operator new and delete and the C allocator.
+ */
+quint64 allocationCount();
+
+#endif // ALLOCATIONCOUNTER_H
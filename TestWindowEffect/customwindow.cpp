@@ -2,12 +2,14 @@
 #include <QMouseEvent>
 #include <QDesktopWidget>
 #include <QCursor>
-#include <QSettings>
 #include <QGraphicsDropShadowEffect>
+#include <QWindow>
 #include "CustomWindow.h"
 #include "ui_CustomWindow.h"
+#include "windowsession.h"
+#include "windowshapehints.h"
 
-CustomWindow::CustomWindow(QWidget *parent) : QWidget(parent), ui(new Ui::CustomWindow)
+CustomWindow::CustomWindow(QWidget *parent, const QString &windowId, TitleMode titleMode) : QWidget(parent), ui(new Ui::CustomWindow)
 {
     customState = false;
 
@@ -27,22 +29,27 @@ CustomWindow::CustomWindow(QWidget *parent) : QWidget(parent), ui(new Ui::Custom
     setMouseTracking(true);
     ui->titleBar->setMouseTracking(true);
     ui->LTitle->setMouseTracking(true);
-    ui->tbMenu->setMouseTracking(true);
-    ui->pbMin->setMouseTracking(true);
-    ui->pbMax->setMouseTracking(true);
-    ui->pbClose->setMouseTracking(true);
     ui->centralWidget->setMouseTracking(true);
 
     centralLayout = new QHBoxLayout(ui->centralWidget);
     centralLayout->setContentsMargins(9,9,9,9);
+    ui->centralWidget->installEventFilter(this);
+
+    liveResizeTimer = new QTimer(this);
+    liveResizeTimer->setSingleShot(true);
+    liveResizeTimer->setTimerType(Qt::CoarseTimer);
+    liveResizeTimer->setInterval(LIVE_RESIZE_INTERVAL);
+    connect(liveResizeTimer, SIGNAL(timeout()), this, SLOT(relayoutLiveResize()));
 
     addAction(ui->actionClose);
 
-    connect(ui->pbMin, SIGNAL(clicked()), this, SLOT(minimizeBtnClicked()));
-    connect(ui->pbMax, SIGNAL(clicked()), this, SLOT(maximizeBtnClicked()));
-    connect(ui->pbClose, SIGNAL(clicked()), this, SLOT(close()));
+    tbMenu = 0;
+    pbMin = 0;
+    pbMax = 0;
+    pbClose = 0;
+    titlebarMenu = 0;
 
-    m_titleMode = FullTitle;
+    m_titleMode = titleMode;
     moveWidget = false;
     inResizeZone = false;
     allowToResize = false;
@@ -50,6 +57,7 @@ CustomWindow::CustomWindow(QWidget *parent) : QWidget(parent), ui(new Ui::Custom
     resizeHorEsq = false;
     resizeDiagSupEsq = false;
     resizeDiagSupDer = false;
+    systemMoveResize = false;
 
     QGraphicsDropShadowEffect *bodyShadow = new QGraphicsDropShadowEffect;
     bodyShadow->setBlurRadius(12.0);
@@ -57,8 +65,9 @@ CustomWindow::CustomWindow(QWidget *parent) : QWidget(parent), ui(new Ui::Custom
     bodyShadow->setOffset(0, 0);
     ui->widget->setGraphicsEffect(bodyShadow);
 
-    QSettings settings("dialogs.ini", QSettings::IniFormat);
-    QRect geo = settings.value("geometry").toRect();
+    this->windowId = WindowSession::instance()->registerWindow(windowId);
+    WindowSession::WindowState state = WindowSession::instance()->state(this->windowId);
+    QRect geo = state.geometry;
 
     if (geo.height() > 0 and geo.x() < QApplication::desktop()->width() and geo.width() > 0 and geo.y() < QApplication::desktop()->height())
     {
@@ -68,20 +77,31 @@ CustomWindow::CustomWindow(QWidget *parent) : QWidget(parent), ui(new Ui::Custom
 
     currentGeometry = this->geometry();
 
-    if (settings.value("maximized").toBool())
+    setCentralWidget(sliderWidget, "Custom Window");
+
+    if (state.customMode)
+        setCustomMode(true);
+
+    if (state.maximized)
     {
         showMaximized();
-        ui->pbMax->setIcon(QIcon(":/images/images/restore.png"));
+
+        if (pbMax)
+            pbMax->setIcon(QIcon(":/images/images/restore.png"));
     }
 
-    setCentralWidget(sliderWidget, "Custom Window");
+    setTitlebarMode(titleMode);
 }
 
 CustomWindow::~CustomWindow()
 {
-    QSettings settings("dialogs.ini", QSettings::IniFormat);
-    settings.setValue("geometry", geometry());
-    settings.setValue("maximized", isMaximized());
+    WindowSession::WindowState state;
+    state.geometry = geometry();
+    state.maximized = isMaximized();
+    state.customMode = customState;
+
+    WindowSession::instance()->setState(windowId, state);
+    WindowSession::instance()->unregisterWindow(windowId);
 
     delete sliderWidget;
     delete ui;
@@ -95,6 +115,7 @@ void CustomWindow::changeState(bool st)
     if (!customState)
     {
         ui->titleBar->setVisible(false);
+        updateTitlebarButtons();
         ui->widget->setStyleSheet("background-color: rgb(255, 255, 255);");
 
         Qt::WindowFlags flags = windowFlags();
@@ -108,12 +129,14 @@ void CustomWindow::changeState(bool st)
         emit setMaxPosition();
         this->setGeometry(currentGeometry);
         show();
+        updateShapeHints();
         update();
     }
     else
     {
         ui->widget->setStyleSheet("");
         ui->titleBar->setVisible(true);
+        updateTitlebarButtons();
 
         setWindowFlags(Qt::CustomizeWindowHint);
         setWindowFlags(Qt::FramelessWindowHint);
@@ -122,6 +145,7 @@ void CustomWindow::changeState(bool st)
         currentGeometry = this->geometry();
         this->setGeometry(currentGeometry);
         show();
+        updateShapeHints();
         update();
     }
 }
@@ -197,6 +221,12 @@ void CustomWindow::mousePressEvent(QMouseEvent *e)
 {
     if (e->button() == Qt::LeftButton)
     {
+        if (systemMoveResize and startSystemDrag(e->pos()))
+        {
+            e->accept();
+            return;
+        }
+
         if (inResizeZone)
         {
             allowToResize = true;
@@ -212,6 +242,8 @@ void CustomWindow::mousePressEvent(QMouseEvent *e)
             }
             else if (e->pos().x() <= PIXELS_TO_ACT)
                 resizeHorEsq = true;
+
+            beginLiveResize();
         }
         else if (e->pos().x() >= PIXELS_TO_ACT and e->pos().x() < ui->titleBar->geometry().width()
                  and e->pos().y() >= PIXELS_TO_ACT and e->pos().y() < ui->titleBar->geometry().height())
@@ -226,6 +258,9 @@ void CustomWindow::mousePressEvent(QMouseEvent *e)
 
 void CustomWindow::mouseReleaseEvent(QMouseEvent *e)
 {
+    if (allowToResize)
+        endLiveResize();
+
     moveWidget = false;
     allowToResize = false;
     resizeVerSup = false;
@@ -238,9 +273,9 @@ void CustomWindow::mouseReleaseEvent(QMouseEvent *e)
 
 void CustomWindow::mouseDoubleClickEvent(QMouseEvent *e)
 {
-    if (e->pos().x() < ui->tbMenu->geometry().right() and e->pos().y() < ui->tbMenu->geometry().bottom()
-        and e->pos().x() >=  ui->tbMenu->geometry().x() and e->pos().y() >= ui->tbMenu->geometry().y()
-        and ui->tbMenu->isVisible())
+    if (tbMenu and e->pos().x() < tbMenu->geometry().right() and e->pos().y() < tbMenu->geometry().bottom()
+        and e->pos().x() >=  tbMenu->geometry().x() and e->pos().y() >= tbMenu->geometry().y()
+        and tbMenu->isVisible())
         close();
     else if (e->pos().x() < ui->titleBar->geometry().width()
              and e->pos().y() < ui->titleBar->geometry().height()
@@ -257,6 +292,28 @@ void CustomWindow::paintEvent (QPaintEvent *)
     style()->drawPrimitive (QStyle::PE_Widget, &opt, &p, this);
 }
 
+void CustomWindow::resizeEvent(QResizeEvent *e)
+{
+    QWidget::resizeEvent(e);
+    updateShapeHints();
+}
+
+QRect CustomWindow::contentRect() const
+{
+    if (!customState)
+        return rect();
+
+    return ui->widget->geometry().marginsRemoved(ui->verticalLayout->contentsMargins());
+}
+
+void CustomWindow::updateShapeHints()
+{
+    QRect content = contentRect();
+    QRect input = content.adjusted(-PIXELS_TO_ACT, -PIXELS_TO_ACT, PIXELS_TO_ACT, PIXELS_TO_ACT) & rect();
+
+    setWindowShapeHints(this, QRegion(content), QRegion(input));
+}
+
 void CustomWindow::moveWindow(QMouseEvent *e)
 {
     if (e->buttons() & Qt::LeftButton)
@@ -378,6 +435,165 @@ void CustomWindow::resizeWindow(QMouseEvent *e)
     }
 }
 
+Qt::Edges CustomWindow::resizeEdges(const QPoint &pos) const
+{
+    Qt::Edges edges;
+
+    if (pos.x() <= PIXELS_TO_ACT)
+        edges |= Qt::LeftEdge;
+    else if (pos.x() >= geometry().width() - PIXELS_TO_ACT)
+        edges |= Qt::RightEdge;
+
+    if (pos.y() <= PIXELS_TO_ACT)
+        edges |= Qt::TopEdge;
+    else if (pos.y() >= geometry().height() - PIXELS_TO_ACT)
+        edges |= Qt::BottomEdge;
+
+    return edges;
+}
+
+bool CustomWindow::startSystemDrag(const QPoint &pos)
+{
+#if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
+    QWindow *window = windowHandle();
+
+    if (!window)
+        return false;
+
+    if (inResizeZone)
+    {
+        Qt::Edges edges = resizeEdges(pos);
+
+        if (!edges)
+            return false;
+
+        return window->startSystemResize(edges);
+    }
+
+    if (pos.x() >= PIXELS_TO_ACT and pos.x() < ui->titleBar->geometry().width()
+        and pos.y() >= PIXELS_TO_ACT and pos.y() < ui->titleBar->geometry().height())
+        return window->startSystemMove();
+#else
+    Q_UNUSED(pos);
+#endif
+
+    return false;
+}
+
+void CustomWindow::setCustomMode(bool custom)
+{
+    sliderWidget->setCustomWindow(custom);
+
+    if (custom != customState)
+        changeState(custom);
+}
+
+bool CustomWindow::isCustomMode() const
+{
+    return customState;
+}
+
+void CustomWindow::setSystemMoveResize(bool enable)
+{
+    systemMoveResize = enable;
+}
+
+void CustomWindow::setLiveResizePolicy(QWidget *widget, LiveResizePolicy policy)
+{
+    if (policy == LiveRelayout)
+        liveResizePolicies.remove(widget);
+    else
+        liveResizePolicies.insert(widget, policy);
+}
+
+bool CustomWindow::eventFilter(QObject *obj, QEvent *e)
+{
+    if (obj == ui->centralWidget and e->type() == QEvent::Resize and !resizeSnapshots.isEmpty())
+    {
+        QSize size = ui->centralWidget->size();
+        qreal sx = qreal(size.width()) / qMax(1, liveResizeBase.width());
+        qreal sy = qreal(size.height()) / qMax(1, liveResizeBase.height());
+
+        for (int i = 0; i < resizeSnapshots.size(); ++i)
+        {
+            const QRect &g = resizeSnapshots.at(i).geometry;
+            resizeSnapshots.at(i).view->setGeometry(qRound(g.x() * sx), qRound(g.y() * sy),
+                                                    qRound(g.width() * sx), qRound(g.height() * sy));
+        }
+
+        if (!liveResizeTimer->isActive())
+            liveResizeTimer->start();
+    }
+
+    return QWidget::eventFilter(obj, e);
+}
+
+void CustomWindow::beginLiveResize()
+{
+    QHash<QWidget *, LiveResizePolicy>::const_iterator it = liveResizePolicies.constBegin();
+
+    for (; it != liveResizePolicies.constEnd(); ++it)
+    {
+        QWidget *widget = it.key();
+
+        if (centralLayout->indexOf(widget) == -1 or !widget->isVisible())
+            continue;
+
+        ResizeSnapshot *view = new ResizeSnapshot(ui->centralWidget);
+        view->setKeepAspectRatio(it.value() == LetterboxSnapshot);
+        view->setPixmap(widget->grab());
+        view->setGeometry(widget->geometry());
+        view->show();
+        view->raise();
+
+        LiveResizeSnapshot snapshot = { widget, view, widget->geometry() };
+        resizeSnapshots.append(snapshot);
+    }
+
+    if (resizeSnapshots.isEmpty())
+        return;
+
+    liveResizeBase = ui->centralWidget->size();
+    centralLayout->setEnabled(false);
+}
+
+void CustomWindow::endLiveResize()
+{
+    if (resizeSnapshots.isEmpty())
+        return;
+
+    liveResizeTimer->stop();
+
+    for (int i = 0; i < resizeSnapshots.size(); ++i)
+        delete resizeSnapshots.at(i).view;
+    resizeSnapshots.clear();
+
+    centralLayout->setEnabled(true);
+    centralLayout->invalidate();
+    centralLayout->activate();
+}
+
+void CustomWindow::relayoutLiveResize()
+{
+    if (resizeSnapshots.isEmpty())
+        return;
+
+    centralLayout->setEnabled(true);
+    centralLayout->invalidate();
+    centralLayout->activate();
+
+    for (int i = 0; i < resizeSnapshots.size(); ++i)
+    {
+        LiveResizeSnapshot &snapshot = resizeSnapshots[i];
+        snapshot.geometry = snapshot.widget->geometry();
+        snapshot.view->setPixmap(snapshot.widget->grab());
+        snapshot.view->setGeometry(snapshot.geometry);
+    }
+
+    liveResizeBase = ui->centralWidget->size();
+    centralLayout->setEnabled(false);
+}
+
 void CustomWindow::setCentralWidget(QWidget *widget, const QString &widgetName)
 {
     centralLayout->addWidget(widget);
@@ -385,74 +601,144 @@ void CustomWindow::setCentralWidget(QWidget *widget, const QString &widgetName)
     ui->LTitle->setText(widgetName);
 }
 
-void CustomWindow::setTitlebarMode(const TitleMode &flag)
+int CustomWindow::titlebarButtons(TitleMode mode)
 {
-    m_titleMode = flag;
-
-    switch (m_titleMode)
+    switch (mode)
     {
         case CleanTitle:
-            ui->tbMenu->setHidden(true);
-            ui->pbMin->setHidden(true);
-            ui->pbMax->setHidden(true);
-            ui->pbClose->setHidden(true);
-            break;
+            return 0;
         case OnlyCloseButton:
-            ui->tbMenu->setHidden(true);
-            ui->pbMin->setHidden(true);
-            ui->pbMax->setHidden(true);
-            break;
+            return CloseButton;
         case MenuOff:
-            ui->tbMenu->setHidden(true);
-            break;
+            return MinimizeButton | MaximizeButton | CloseButton;
         case MaxMinOff:
-            ui->pbMin->setHidden(true);
-            ui->pbMax->setHidden(true);
-            break;
+            return MenuButton | CloseButton;
         case FullScreenMode:
-            ui->pbMax->setHidden(true);
-            showMaximized();
-            break;
         case MaximizeModeOff:
-            ui->pbMax->setHidden(true);
-            break;
+            return MenuButton | MinimizeButton | CloseButton;
         case MinimizeModeOff:
-            ui->pbMin->setHidden(true);
-            break;
+            return MenuButton | MaximizeButton | CloseButton;
         case FullTitle:
-            ui->tbMenu->setVisible(true);
-            ui->pbMin->setVisible(true);
-            ui->pbMax->setVisible(true);
-            ui->pbClose->setVisible(true);
-            break;
-            break;
         default:
-            ui->tbMenu->setVisible(true);
-            ui->pbMin->setVisible(true);
-            ui->pbMax->setVisible(true);
-            ui->pbClose->setVisible(true);
-            break;
+            return MenuButton | MinimizeButton | MaximizeButton | CloseButton;
+    }
+}
+
+QPushButton *CustomWindow::createTitlebarButton(const QString &icon, QWidget *before)
+{
+    QPushButton *button = new QPushButton(ui->titleBar);
+    button->setFixedSize(20, 20);
+    button->setIcon(QIcon(icon));
+    button->setIconSize(QSize(20, 20));
+    button->setFlat(true);
+    button->setMouseTracking(true);
+
+    ui->horizontalLayout->insertWidget(before ? ui->horizontalLayout->indexOf(before) : -1, button);
+
+    return button;
+}
+
+void CustomWindow::updateTitlebarButtons()
+{
+    // the buttons only exist while the custom titlebar is shown and the mode needs them
+    int buttons = customState ? titlebarButtons(m_titleMode) : 0;
+
+    if ((buttons & MenuButton) and !tbMenu)
+    {
+        tbMenu = new QToolButton(ui->titleBar);
+        tbMenu->setFixedSize(20, 20);
+        tbMenu->setIcon(QIcon(":/images/images/custom_icon.png"));
+        tbMenu->setIconSize(QSize(20, 20));
+        tbMenu->setPopupMode(QToolButton::InstantPopup);
+        tbMenu->setAutoRaise(true);
+        tbMenu->setMouseTracking(true);
+
+        if (titlebarMenu)
+        {
+            tbMenu->setMenu(titlebarMenu);
+            tbMenu->setIcon(QIcon(titlebarIcon));
+        }
+
+        ui->horizontalLayout->insertWidget(0, tbMenu);
+    }
+    else if (!(buttons & MenuButton) and tbMenu)
+    {
+        delete tbMenu;
+        tbMenu = 0;
+    }
+
+    if ((buttons & CloseButton) and !pbClose)
+    {
+        pbClose = createTitlebarButton(":/images/images/close.png", 0);
+        connect(pbClose, SIGNAL(clicked()), this, SLOT(close()));
+    }
+    else if (!(buttons & CloseButton) and pbClose)
+    {
+        delete pbClose;
+        pbClose = 0;
+    }
+
+    if ((buttons & MaximizeButton) and !pbMax)
+    {
+        pbMax = createTitlebarButton(isFullScreen() or isMaximized() ? ":/images/images/restore.png"
+                                                                     : ":/images/images/maximize.png", pbClose);
+        connect(pbMax, SIGNAL(clicked()), this, SLOT(maximizeBtnClicked()));
+    }
+    else if (!(buttons & MaximizeButton) and pbMax)
+    {
+        delete pbMax;
+        pbMax = 0;
     }
+
+    if ((buttons & MinimizeButton) and !pbMin)
+    {
+        pbMin = createTitlebarButton(":/images/images/minimize.png", pbMax ? pbMax : pbClose);
+        connect(pbMin, SIGNAL(clicked()), this, SLOT(minimizeBtnClicked()));
+    }
+    else if (!(buttons & MinimizeButton) and pbMin)
+    {
+        delete pbMin;
+        pbMin = 0;
+    }
+}
+
+void CustomWindow::setTitlebarMode(const TitleMode &flag)
+{
+    m_titleMode = flag;
+
+    updateTitlebarButtons();
+
+    if (m_titleMode == FullScreenMode)
+        showMaximized();
+
     ui->LTitle->setVisible(true);
 }
 
 void CustomWindow::setTitlebarMenu(QMenu *menu, const QString &icon)
 {
-    ui->tbMenu->setMenu(menu);
-    ui->tbMenu->setIcon(QIcon(icon));
+    titlebarMenu = menu;
+    titlebarIcon = icon;
+
+    if (tbMenu)
+    {
+        tbMenu->setMenu(menu);
+        tbMenu->setIcon(QIcon(icon));
+    }
 }
 
 void CustomWindow::maximizeBtnClicked()
 {
     if (isFullScreen() or isMaximized())
     {
-        ui->pbMax->setIcon(QIcon(":/images/images/maximize.png"));
+        if (pbMax)
+            pbMax->setIcon(QIcon(":/images/images/maximize.png"));
         setWindowState(windowState() & ~Qt::WindowFullScreen & ~Qt::WindowMaximized);
         emit setMaxPosition();
     }
     else
     {
-        ui->pbMax->setIcon(QIcon(":/images/images/restore.png"));
+        if (pbMax)
+            pbMax->setIcon(QIcon(":/images/images/restore.png"));
         setWindowState(windowState() | Qt::WindowFullScreen | Qt::WindowMaximized);
         emit setMaxPosition();
     }
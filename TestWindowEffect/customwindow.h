@@ -4,14 +4,24 @@
 #include <QWidget>
 #include <QHBoxLayout>
 #include <QMenu>
+#include <QHash>
+#include <QTimer>
+#include <QToolButton>
+#include <QPushButton>
 
 #include "sliderwidget.h"
+#include "resizesnapshot.h"
 
 /**
   * Pixels around the border to mouse cursor change.
   **/
 #define PIXELS_TO_ACT 5
 
+/**
+  * Milliseconds between two relayouts of the central widget during a live resize.
+  **/
+#define LIVE_RESIZE_INTERVAL 100
+
 namespace Ui
 {
     class CustomWindow;
@@ -34,11 +44,28 @@ class CustomWindow : public QWidget
          * @brief The TitleMode defines the type of titlebar that will be shown.
          */
         enum TitleMode { CleanTitle = 0, OnlyCloseButton, MenuOff, MaxMinOff, FullScreenMode, MaximizeModeOff, MinimizeModeOff, FullTitle };
+        /**
+         * @brief The LiveResizePolicy defines how a central widget is shown while the window is resized
+         * from its borders. LiveRelayout relayouts and repaints on every step, StretchSnapshot stretches
+         * an image of the widget taken at drag start and LetterboxSnapshot scales that image with its
+         * aspect ratio, centered.
+         */
+        enum LiveResizePolicy { LiveRelayout = 0, StretchSnapshot, LetterboxSnapshot };
+        /**
+         * @brief The TitleButton flags the titlebar buttons a TitleMode shows.
+         */
+        enum TitleButton { MenuButton = 1, MinimizeButton = 2, MaximizeButton = 4, CloseButton = 8 };
+        /**
+         * @brief titlebarButtons Returns the TitleButton flags of a titlebar mode.
+         */
+        static int titlebarButtons(TitleMode mode);
         /**
          * @brief CustomWindow Main constructor that configures de UI with interal parameters.
          * @param parent The parent widget.
+         * @param windowId The id used to store the window state in the WindowSession.
+         * @param titleMode The titlebar mode, given here no button the mode hides is ever created.
          */
-        explicit CustomWindow(QWidget *parent = 0);
+        explicit CustomWindow(QWidget *parent = 0, const QString &windowId = "main", TitleMode titleMode = FullTitle);
         /**
          * @brief CustomWindow destructor.
          */
@@ -61,6 +88,30 @@ class CustomWindow : public QWidget
          * @param widgetName The name of the window.
          */
         void setCentralWidget(QWidget *widget, const QString &widgetName);
+        /**
+         * @brief setSystemMoveResize Hands the interactive move and resize of the window to the
+         * window manager. If the platform can not start a system move/resize the manual one is used.
+         * @param enable True to let the window manager drive move and resize.
+         */
+        void setSystemMoveResize(bool enable);
+        /**
+         * @brief setCustomMode Switches the window and its slider to the custom or the standard
+         * mode without animation.
+         * @param custom True for the frameless window with the custom titlebar.
+         */
+        void setCustomMode(bool custom);
+        /**
+         * @brief isCustomMode Returns true if the window is in the custom mode.
+         */
+        bool isCustomMode() const;
+        /**
+         * @brief setLiveResizePolicy Defines how a widget set with setCentralWidget() behaves while the
+         * window is resized. Snapshot policies relayout the widget every LIVE_RESIZE_INTERVAL and fully
+         * on mouse release.
+         * @param widget The central widget.
+         * @param policy The policy to use, LiveRelayout by default.
+         */
+        void setLiveResizePolicy(QWidget *widget, LiveResizePolicy policy);
 
     protected slots:
         /**
@@ -77,10 +128,26 @@ class CustomWindow : public QWidget
         void setMaxPosition();
 
     private:
+        /**
+         * @brief The LiveResizeSnapshot struct keeps the image shown instead of a central widget
+         * during a live resize.
+         */
+        struct LiveResizeSnapshot
+        {
+            QWidget *widget;
+            ResizeSnapshot *view;
+            QRect geometry;
+        };
+
         SliderWidget *sliderWidget;
         bool customState;
         QRect currentGeometry;
 
+        /**
+         * @brief windowId Id of the window in the WindowSession.
+         */
+        QString windowId;
+
         /**
          * @brief ui User interface module.
          */
@@ -93,6 +160,19 @@ class CustomWindow : public QWidget
          * @brief dragPosition Increment of the position movement.
          */
         QPoint dragPosition;
+        /**
+         * @brief tbMenu, pbMin, pbMax, pbClose Titlebar buttons, only created while the custom
+         * titlebar is shown and the titlebar mode needs them, null otherwise.
+         */
+        QToolButton *tbMenu;
+        QPushButton *pbMin;
+        QPushButton *pbMax;
+        QPushButton *pbClose;
+        /**
+         * @brief titlebarMenu Menu and icon set with setTitlebarMenu(), for a menu button created later.
+         */
+        QMenu *titlebarMenu;
+        QString titlebarIcon;
         /**
          * @brief m_titleMode Flags that defines the current titlebar mode.
          */
@@ -125,6 +205,26 @@ class CustomWindow : public QWidget
          * @brief resizeDiagSupDer Specifies if the resize is in the top right of the window.
          */
         bool resizeDiagSupDer;
+        /**
+         * @brief systemMoveResize Specifies if move and resize are delegated to the window manager.
+         */
+        bool systemMoveResize;
+        /**
+         * @brief liveResizePolicies Live resize policy of each central widget.
+         */
+        QHash<QWidget *, LiveResizePolicy> liveResizePolicies;
+        /**
+         * @brief resizeSnapshots Snapshots shown while the window is being resized.
+         */
+        QList<LiveResizeSnapshot> resizeSnapshots;
+        /**
+         * @brief liveResizeBase Size of the central area when the snapshots were taken.
+         */
+        QSize liveResizeBase;
+        /**
+         * @brief liveResizeTimer Throttles the relayout of the central widget during a live resize.
+         */
+        QTimer *liveResizeTimer;
 
         /**
          * @brief mouseMoveEvent Overloaded member that moves of resizes depending of the
@@ -153,12 +253,60 @@ class CustomWindow : public QWidget
          * @brief paintEvent Overloaded method that allows to customize the styles of the window.
          */
         void paintEvent (QPaintEvent *);
+        /**
+         * @brief resizeEvent Overloaded method that updates the window shape hints.
+         */
+        void resizeEvent(QResizeEvent *e);
+        /**
+         * @brief contentRect Returns the solid part of the window, without the shadow margin.
+         */
+        QRect contentRect() const;
+        /**
+         * @brief updateShapeHints Publishes the opaque content and the input region, the content
+         * and the PIXELS_TO_ACT resize zones, to the window manager.
+         */
+        void updateShapeHints();
+        /**
+         * @brief updateTitlebarButtons Creates the titlebar buttons needed by the current mode and
+         * deletes the others.
+         */
+        void updateTitlebarButtons();
+        /**
+         * @brief createTitlebarButton Creates a titlebar push button in the titlebar layout.
+         * @param icon The path to the icon.
+         * @param before The button it is inserted before, appended if null.
+         */
+        QPushButton *createTitlebarButton(const QString &icon, QWidget *before);
         /**
          * @brief resizeWindow Method that calculates the resize and new position of the window an
          * does this actions.
          * @param e The mouse event to calculate the new position and size.
          */
         void resizeWindow(QMouseEvent *e);
+        /**
+         * @brief resizeEdges Returns the window edges under the position using PIXELS_TO_ACT zones.
+         * @param pos The position in window coordinates.
+         */
+        Qt::Edges resizeEdges(const QPoint &pos) const;
+        /**
+         * @brief startSystemDrag Starts a system move or resize from the position if the platform
+         * supports it.
+         * @param pos The position in window coordinates where the drag started.
+         * @return True if the window manager took the drag.
+         */
+        bool startSystemDrag(const QPoint &pos);
+        /**
+         * @brief eventFilter Follows the resizes of the central area to place the snapshots.
+         */
+        bool eventFilter(QObject *obj, QEvent *e);
+        /**
+         * @brief beginLiveResize Takes the snapshots of the central widgets and freezes their layout.
+         */
+        void beginLiveResize();
+        /**
+         * @brief endLiveResize Removes the snapshots and relayouts the central widgets.
+         */
+        void endLiveResize();
 
     private slots:
         /**
@@ -169,6 +317,10 @@ class CustomWindow : public QWidget
          * @brief minimizeBtnClicked Minimizes or restores the window depending on the last status.
          */
         void minimizeBtnClicked();
+        /**
+         * @brief relayoutLiveResize Relayouts the central widgets and refreshes their snapshots.
+         */
+        void relayoutLiveResize();
 };
 
 #endif // CustomWindow_H
@@ -0,0 +1,229 @@
+#include "inputtrace.h"
+#include "customwindow.h"
+
+#include <QApplication>
+#include <QMouseEvent>
+#include <QThread>
+#include <algorithm>
+
+InputTraceRecorder::InputTraceRecorder(CustomWindow *target, QObject *parent) :
+    QObject(parent),
+    target(target),
+    lastEvent(0)
+{
+}
+
+InputTraceRecorder::~InputTraceRecorder()
+{
+    stop();
+}
+
+bool InputTraceRecorder::start(const QString &fileName)
+{
+    stop();
+
+    file.setFileName(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+
+    stream.setDevice(&file);
+    stream.setByteOrder(QDataStream::LittleEndian);
+
+    QRect geo = target->isMaximized() ? target->normalGeometry() : target->geometry();
+    quint8 flags = 0;
+    if (target->isCustomMode())
+        flags |= INPUT_TRACE_CUSTOM_MODE;
+    if (target->isMaximized())
+        flags |= INPUT_TRACE_MAXIMIZED;
+
+    stream << INPUT_TRACE_MAGIC << INPUT_TRACE_VERSION
+           << qint32(geo.x()) << qint32(geo.y()) << qint32(geo.width()) << qint32(geo.height()) << flags;
+
+    clock.start();
+    lastEvent = 0;
+    target->installEventFilter(this);
+
+    return true;
+}
+
+void InputTraceRecorder::stop()
+{
+    if (!file.isOpen())
+        return;
+
+    if (target)
+        target->removeEventFilter(this);
+    stream.setDevice(0);
+    file.close();
+}
+
+quint8 InputTraceRecorder::eventCode(QEvent::Type type)
+{
+    switch (type)
+    {
+        case QEvent::MouseMove:
+            return 1;
+        case QEvent::MouseButtonPress:
+            return 2;
+        case QEvent::MouseButtonRelease:
+            return 3;
+        case QEvent::MouseButtonDblClick:
+            return 4;
+        default:
+            return 0;
+    }
+}
+
+QEvent::Type InputTraceRecorder::eventType(quint8 code)
+{
+    switch (code)
+    {
+        case 1:
+            return QEvent::MouseMove;
+        case 2:
+            return QEvent::MouseButtonPress;
+        case 3:
+            return QEvent::MouseButtonRelease;
+        case 4:
+            return QEvent::MouseButtonDblClick;
+        default:
+            return QEvent::None;
+    }
+}
+
+bool InputTraceRecorder::eventFilter(QObject *obj, QEvent *e)
+{
+    quint8 code = eventCode(e->type());
+
+    if (obj == target and code)
+    {
+        QMouseEvent *me = static_cast<QMouseEvent *>(e);
+        qint64 now = clock.nsecsElapsed() / 1000;
+
+        stream << quint32(now - lastEvent) << code
+               << quint8(me->button()) << quint8(me->buttons()) << quint8(int(me->modifiers()) >> 25)
+               << qint16(me->pos().x()) << qint16(me->pos().y())
+               << qint16(me->globalPos().x()) << qint16(me->globalPos().y());
+
+        lastEvent = now;
+    }
+
+    return QObject::eventFilter(obj, e);
+}
+
+bool InputTraceReplayer::load(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream stream(&file);
+    stream.setByteOrder(QDataStream::LittleEndian);
+
+    quint32 magic;
+    quint16 version;
+    qint32 x, y, w, h;
+    quint8 flags;
+    stream >> magic >> version;
+
+    if (stream.status() != QDataStream::Ok or magic != INPUT_TRACE_MAGIC or version != INPUT_TRACE_VERSION)
+        return false;
+
+    stream >> x >> y >> w >> h >> flags;
+
+    if (stream.status() != QDataStream::Ok)
+        return false;
+
+    initialGeometry = QRect(x, y, w, h);
+    initialFlags = flags;
+    events.clear();
+
+    while (!stream.atEnd())
+    {
+        InputTraceEvent ev;
+        stream >> ev.delay >> ev.type >> ev.button >> ev.buttons >> ev.modifiers
+               >> ev.x >> ev.y >> ev.globalX >> ev.globalY;
+
+        // a record cut by the end of the file is dropped, the recording was interrupted
+        if (stream.status() != QDataStream::Ok)
+            break;
+
+        if (InputTraceRecorder::eventType(ev.type) == QEvent::None)
+        {
+            events.clear();
+            return false;
+        }
+
+        events.append(ev);
+    }
+
+    return true;
+}
+
+void InputTraceReplayer::replay(CustomWindow *target, Speed speed)
+{
+    latencies.clear();
+    latencies.reserve(events.size());
+
+    // the trace only replays the same code path from the same state
+    target->setCustomMode(initialFlags & INPUT_TRACE_CUSTOM_MODE);
+    target->showNormal();
+    target->setGeometry(initialGeometry);
+    if (initialFlags & INPUT_TRACE_MAXIMIZED)
+        target->showMaximized();
+    QCoreApplication::processEvents();
+
+    QElapsedTimer clock;
+    QElapsedTimer handling;
+    qint64 due = 0;
+    clock.start();
+
+    for (int i = 0; i < events.size(); ++i)
+    {
+        const InputTraceEvent &ev = events.at(i);
+
+        if (speed == OriginalSpeed)
+        {
+            due += ev.delay;
+            qint64 wait = due - clock.nsecsElapsed() / 1000;
+            if (wait > 0)
+                QThread::usleep(wait);
+        }
+
+        QMouseEvent event(InputTraceRecorder::eventType(ev.type),
+                          QPointF(ev.x, ev.y), QPointF(ev.globalX, ev.globalY),
+                          Qt::MouseButton(ev.button), Qt::MouseButtons(ev.buttons),
+                          Qt::KeyboardModifiers(int(ev.modifiers) << 25));
+
+        handling.start();
+        QApplication::sendEvent(target, &event);
+        QCoreApplication::processEvents();
+        latencies.append(handling.nsecsElapsed());
+    }
+
+    finalGeometry = target->geometry();
+}
+
+void InputTraceReplayer::printReport(QTextStream &out) const
+{
+    out << "events: " << latencies.size() << "\n";
+
+    if (!latencies.isEmpty())
+    {
+        QVector<qint64> sorted = latencies;
+        std::sort(sorted.begin(), sorted.end());
+
+        qint64 total = 0;
+        for (int i = 0; i < sorted.size(); ++i)
+            total += sorted.at(i);
+
+        out << "latency us: min " << sorted.first() / 1000
+            << " median " << sorted.at(sorted.size() / 2) / 1000
+            << " p99 " << sorted.at((sorted.size() - 1) * 99 / 100) / 1000
+            << " max " << sorted.last() / 1000
+            << " mean " << total / sorted.size() / 1000 << "\n";
+    }
+
+    out << "final geometry: " << finalGeometry.x() << "," << finalGeometry.y()
+        << " " << finalGeometry.width() << "x" << finalGeometry.height() << "\n";
+}
@@ -0,0 +1,126 @@
+#ifndef INPUTTRACE_H
+#define INPUTTRACE_H
+
+#include <QObject>
+#include <QWidget>
+#include <QPointer>
+#include <QFile>
+#include <QDataStream>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <QVector>
+
+class CustomWindow;
+
+/**
+ * @brief The InputTraceEvent struct is one mouse event of a trace. The trace file starts with the
+ * INPUT_TRACE_MAGIC and INPUT_TRACE_VERSION, the initial geometry and state flags of the window
+ * and then one 16 bytes record per event.
+ */
+struct InputTraceEvent
+{
+    quint32 delay;      //microseconds since the previous event
+    quint8 type;        //QEvent::Type, see InputTraceRecorder::eventCode()
+    quint8 button;
+    quint8 buttons;
+    quint8 modifiers;   //Qt::KeyboardModifiers >> 25
+    qint16 x, y;
+    qint16 globalX, globalY;
+};
+
+const quint32 INPUT_TRACE_MAGIC = 0x43574954; //"CWIT"
+const quint16 INPUT_TRACE_VERSION = 2;
+const quint8 INPUT_TRACE_CUSTOM_MODE = 0x01;
+const quint8 INPUT_TRACE_MAXIMIZED = 0x02;
+
+/**
+ * @brief The InputTraceRecorder class writes the mouse events received by a window to a compact
+ * binary trace that can be played back with InputTraceReplayer.
+ */
+class InputTraceRecorder : public QObject
+{
+    Q_OBJECT
+
+    public:
+        /**
+         * @brief InputTraceRecorder Main constructor.
+         * @param target The window whose mouse events are recorded.
+         * @param parent The parent object.
+         */
+        explicit InputTraceRecorder(CustomWindow *target, QObject *parent = 0);
+        /**
+         * @brief InputTraceRecorder destructor, finishes the trace.
+         */
+        ~InputTraceRecorder();
+        /**
+         * @brief start Opens the trace file and starts recording.
+         * @param fileName The path of the trace file.
+         * @return False if the file can not be written.
+         */
+        bool start(const QString &fileName);
+        /**
+         * @brief stop Stops recording and closes the trace file.
+         */
+        void stop();
+
+        /**
+         * @brief eventCode Returns the code stored in the trace for a mouse event type, 0 otherwise.
+         */
+        static quint8 eventCode(QEvent::Type type);
+        /**
+         * @brief eventType Returns the mouse event type stored with eventCode().
+         */
+        static QEvent::Type eventType(quint8 code);
+
+    protected:
+        bool eventFilter(QObject *obj, QEvent *e);
+
+    private:
+        QPointer<CustomWindow> target;
+        QFile file;
+        QDataStream stream;
+        QElapsedTimer clock;
+        qint64 lastEvent;
+};
+
+/**
+ * @brief The InputTraceReplayer class feeds a recorded trace back into a window, at the original
+ * pace or as fast as possible, and measures how long the window takes to handle each event.
+ */
+class InputTraceReplayer
+{
+    public:
+        enum Speed { OriginalSpeed = 0, MaximumSpeed };
+
+        /**
+         * @brief load Reads a trace written by InputTraceRecorder.
+         * @param fileName The path of the trace file.
+         * @return False if the file can not be read, is not a trace or has an unknown event.
+         */
+        bool load(const QString &fileName);
+        /**
+         * @brief replay Sends the trace events to the window. The window is first set to the mode,
+         * maximized state and geometry it had when the recording started.
+         * @param target The window that receives the events.
+         * @param speed Whether the original delays between events are kept.
+         */
+        void replay(CustomWindow *target, Speed speed);
+        /**
+         * @brief printReport Writes the latency statistics and the final geometry of the last replay.
+         * @param out The output stream.
+         */
+        void printReport(QTextStream &out) const;
+
+    private:
+        QRect initialGeometry;
+        quint8 initialFlags;
+        QRect finalGeometry;
+        QVector<InputTraceEvent> events;
+        /**
+         * @brief latencies Handling time of each event in nanoseconds, including the posted events
+         * (layout, paint) it caused.
+         */
+        QVector<qint64> latencies;
+};
+
+#endif // INPUTTRACE_H
@@ -1,12 +1,81 @@
 #include <QApplication>
+#include <QCommandLineParser>
 #include "customwindow.h"
+#include "inputtrace.h"
+#include "windowsession.h"
+#include "wakeupcounter.h"
 
 int main(int argc, char *argv[])
 {
     QApplication a(argc, argv);
 
+    QCommandLineParser parser;
+    QCommandLineOption recordOption("record", "Record the mouse events of the window to <file>.", "file");
+    QCommandLineOption replayOption("replay", "Replay the trace <file> and print the handling latency.", "file");
+    QCommandLineOption maxSpeedOption("max-speed", "Replay without the recorded delays between events.");
+    QCommandLineOption wakeupOption("wakeup-stats", "Print the timer and paint wakeups of each window on exit.");
+    parser.addHelpOption();
+    parser.addOption(recordOption);
+    parser.addOption(replayOption);
+    parser.addOption(maxSpeedOption);
+    parser.addOption(wakeupOption);
+    parser.process(a);
+
+    // a replay must not depend on nor change the stored session
+    if (parser.isSet(replayOption))
+        WindowSession::instance()->setPersistent(false);
+
+    WakeupCounter wakeupCounter;
+
     CustomWindow* customWindow = new CustomWindow();
+    if (parser.isSet(wakeupOption))
+        wakeupCounter.watch(customWindow);
+    customWindow->setSystemMoveResize(!parser.isSet(recordOption) and !parser.isSet(replayOption));
     customWindow->show();
 
-    return a.exec();
+    if (parser.isSet(replayOption))
+    {
+        InputTraceReplayer replayer;
+        if (!replayer.load(parser.value(replayOption)))
+        {
+            qWarning("Can not read the trace %s", qPrintable(parser.value(replayOption)));
+            return 1;
+        }
+
+        replayer.replay(customWindow, parser.isSet(maxSpeedOption) ? InputTraceReplayer::MaximumSpeed
+                                                                   : InputTraceReplayer::OriginalSpeed);
+
+        QTextStream out(stdout);
+        replayer.printReport(out);
+
+        customWindow->close();
+        return 0;
+    }
+
+    // the other windows of the stored session
+    QStringList windowIds = WindowSession::instance()->windowIds();
+    for (int i = 0; i < windowIds.size(); ++i)
+    {
+        if (windowIds.at(i) == "main")
+            continue;
+
+        CustomWindow *window = new CustomWindow(0, windowIds.at(i));
+        if (parser.isSet(wakeupOption))
+            wakeupCounter.watch(window);
+        window->show();
+    }
+
+    InputTraceRecorder recorder(customWindow);
+    if (parser.isSet(recordOption) and !recorder.start(parser.value(recordOption)))
+        qWarning("Can not write the trace %s", qPrintable(parser.value(recordOption)));
+
+    int result = a.exec();
+
+    if (parser.isSet(wakeupOption))
+    {
+        QTextStream out(stdout);
+        wakeupCounter.printReport(out);
+    }
+
+    return result;
 }
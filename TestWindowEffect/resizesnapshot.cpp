@@ -0,0 +1,41 @@
+#include "resizesnapshot.h"
+
+#include <QPainter>
+
+ResizeSnapshot::ResizeSnapshot(QWidget *parent) :
+    QWidget(parent),
+    keepAspectRatio(false)
+{
+    setAttribute(Qt::WA_OpaquePaintEvent);
+}
+
+void ResizeSnapshot::setPixmap(const QPixmap &pixmap)
+{
+    this->pixmap = pixmap;
+    update();
+}
+
+void ResizeSnapshot::setKeepAspectRatio(bool keep)
+{
+    keepAspectRatio = keep;
+    update();
+}
+
+void ResizeSnapshot::paintEvent(QPaintEvent *)
+{
+    QPainter painter(this);
+    QRect target = rect();
+
+    if (keepAspectRatio)
+    {
+        QSize size = (QSizeF(pixmap.size()) / pixmap.devicePixelRatioF()).toSize();
+        size.scale(target.size(), Qt::KeepAspectRatio);
+
+        target = QRect(QPoint(0, 0), size);
+        target.moveCenter(rect().center());
+        painter.fillRect(rect(), palette().window());
+    }
+
+    // no SmoothPixmapTransform, the image is only shown for the duration of the resize
+    painter.drawPixmap(target, pixmap);
+}
@@ -0,0 +1,37 @@
+#ifndef RESIZESNAPSHOT_H
+#define RESIZESNAPSHOT_H
+
+#include <QWidget>
+#include <QPixmap>
+
+/**
+ * @brief The ResizeSnapshot class shows the image of a central widget while the window is resized.
+ * The image is drawn with a plain drawPixmap() into the widget rect, without smooth transform, so
+ * a resize step costs less than the relayout it replaces.
+ */
+class ResizeSnapshot : public QWidget
+{
+    Q_OBJECT
+
+    public:
+        explicit ResizeSnapshot(QWidget *parent = 0);
+
+        /**
+         * @brief setPixmap Sets the image of the widget, usually QWidget::grab().
+         */
+        void setPixmap(const QPixmap &pixmap);
+        /**
+         * @brief setKeepAspectRatio Letterboxes the image instead of stretching it.
+         * @param keep True to scale the image with its aspect ratio, centered in the widget.
+         */
+        void setKeepAspectRatio(bool keep);
+
+    protected:
+        void paintEvent(QPaintEvent *);
+
+    private:
+        QPixmap pixmap;
+        bool keepAspectRatio;
+};
+
+#endif // RESIZESNAPSHOT_H
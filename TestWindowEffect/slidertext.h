@@ -0,0 +1,12 @@
+#ifndef SLIDERTEXT_H
+#define SLIDERTEXT_H
+
+/**
+  * Texts drawn by SliderWidget with the embedded font. The build subsets the font to the characters
+  * of this file (pyftsubset --text-file), so a text changed here keeps its glyphs.
+  **/
+#define SLIDER_CAPTION_TEXT "USE SLIDER TO SWITCH WINDOW STATES"
+#define SLIDER_ON_TEXT "ON"
+#define SLIDER_OFF_TEXT "OFF"
+
+#endif // SLIDERTEXT_H
@@ -1,11 +1,18 @@
 #include "sliderwidget.h"
 
+#include <QApplication>
 #include <QPaintEvent>
 #include <QPainter>
 #include <QStyleOption>
 #include <QFontDatabase>
 #include <QPropertyAnimation>
 #include <QTimer>
+#include <QtConcurrent>
+#include "slidertext.h"
+#ifdef SLIDER_ALLOCATION_COUNTER
+#include "allocationcounter.h"
+#endif
+#include <algorithm>
 
 SliderWidget::SliderWidget(QWidget *parent) :
     QWidget(parent),
@@ -13,35 +20,91 @@ SliderWidget::SliderWidget(QWidget *parent) :
     isMaxState(false),
     pos(0),
     isCustomWindow(false),
-    animation(new QPropertyAnimation(this))
+    animation(new QPropertyAnimation(this)),
+    prerenderEnabled(false),
+    prerenderPending(false),
+    prerenderWatcher(new QFutureWatcher<SliderTimeline>(this)),
+    committedState(false),
+    commitImmediately(false),
+    dragging(false),
+    stateHeld(false),
+    heldState(false),
+    dragMoved(false),
+    dragUpdatePending(false),
+    dragPressX(0),
+    dragOffset(0),
+    dragX(0),
+    lastKnobTime(0),
+    knobVelocity(0)
+#ifdef SLIDER_ALLOCATION_COUNTER
+    , steadyFrames(0)
+    , steadyAllocations(0)
+#endif
 {
+    connect(prerenderWatcher, SIGNAL(finished()), this, SLOT(prerenderFinished()));
+
     animation->setTargetObject(this);
     animation->setPropertyName("pos");
 
-    timer = new QTimer;
+    // tigger update on animation finished
+    connect(animation, SIGNAL(finished()), this, SLOT(update()));
+
+    knobClock.start();
+
+    // single shot and coarse, it only delays the window state change
+    timer = new QTimer(this);
+    timer->setSingleShot(true);
+    timer->setTimerType(Qt::CoarseTimer);
     timer->setInterval(ANIMATION_TIME);
 
     connect(timer, SIGNAL(timeout()), this, SLOT(canChangeState()));
 
+    // renders once the resize has settled, not on every step of a drag
+    prerenderTimer = new QTimer(this);
+    prerenderTimer->setSingleShot(true);
+    prerenderTimer->setTimerType(Qt::CoarseTimer);
+    prerenderTimer->setInterval(PRERENDER_DELAY);
+
+    connect(prerenderTimer, SIGNAL(timeout()), this, SLOT(schedulePrerender()));
+
     setAutoFillBackground(true);
 
-    QFontDatabase fontDB;
-    fontDB.addApplicationFont(":/font/AlternateGotNo3D.ttf");
+    myFont = new QFont(fontFamily(), 12, QFont::Bold, false);
+
+}
+
+QString SliderWidget::fontFamily()
+{
+    // the font is registered once per application, not once per slider
+    static int fontId = QFontDatabase::addApplicationFont(":/font/AlternateGotNo3D.ttf");
+    static const QStringList families = QFontDatabase::applicationFontFamilies(fontId);
 
-    myFont = new QFont(fontDB.families().at(0), 12, QFont::Bold, false);
+    if (families.isEmpty())
+        qWarning("SliderWidget: can not load :/font/AlternateGotNo3D.ttf, using the default font");
 
+    return families.value(0);
 }
 
 SliderWidget::~SliderWidget()
 {
     delete myFont;
-    delete timer;
     delete animation;
 }
 
 void SliderWidget::paintEvent(QPaintEvent *)
 {
+    // before the frame is measured, starting an animation is not part of painting it
+    drainRequestedStates();
+
+#ifdef SLIDER_ALLOCATION_COUNTER
+    // the whole frame is measured, QPainter::begin() allocates its state on every frame and is
+    // counted apart
+    quint64 allocations = allocationCount();
+    QPainter painter(this);
+    quint64 painterAllocations = allocationCount() - allocations;
+#else
     QPainter painter(this);
+#endif
 
     int width = this->width();
     int height = this->height();
@@ -50,7 +113,6 @@ void SliderWidget::paintEvent(QPaintEvent *)
 
     centerLeft = QPoint(width / 2 - radius, height / 2);
     centerRight = QPoint(width / 2 + radius, height / 2);
-    float scaleFactor = float(width)/63.2;
 
     if (firstRun)
     {
@@ -58,123 +120,302 @@ void SliderWidget::paintEvent(QPaintEvent *)
         currentColor = COLOR_START;
     }
 
-    myFont->setPointSize(int(scaleFactor));
-    painter.setFont(*myFont);
-    QString titleDown = "USE SLIDER TO SWITCH WINDOW STATES";
-    painter.setPen(QPen(QColor(220, 220, 220)));
-    QRect rect(0, 3 * height / 4 + radius / 2, width, QFontMetrics( *myFont ).height());
-    painter.drawText( rect, Qt::AlignCenter, titleDown );
+    if (dragUpdatePending)
+    {
+        dragUpdatePending = false;
+        applyPosition(dragX + dragOffset);
+    }
 
-    myFont->setPointSize(1.5*int(scaleFactor));
-    painter.setFont(*myFont);
+    bool running = animation->state() == QPropertyAnimation::Running;
 
-    if (!isCustomWindow)
+    if (paintCache.size != size())
     {
-        //draw big ellipse
-        painter.setPen(QPen(currentColor));
-        painter.setBrush(QBrush(currentColor));
+        paintCache.update(size(), *myFont);
+#ifdef SLIDER_ALLOCATION_COUNTER
+        steadyFrames = 0;
+#endif
+    }
 
-        painter.drawEllipse(centerLeft, radius, radius);
-        painter.drawEllipse(centerRight, radius, radius);
-        painter.drawRect(centerLeft.x(), centerLeft.y() - radius, radius * 2 , radius * 2);
+    paintCaption(painter, paintCache);
 
-        //draw small circle inside
-        painter.setPen(QPen(Qt::white));
-        painter.setBrush(QBrush(Qt::white));
-        painter.drawEllipse(QPoint(pos, centerLeft.y()), int(radius - scaleFactor), int(radius - scaleFactor));
+    int frame = -1;
 
-        if (animation->state() == QPropertyAnimation::Running)
-            return;
+    if (running and timeline.size == size() and timeline.dpr == devicePixelRatioF())
+    {
+        //the pre-rendered track closest to the current position, whatever the easing curve
+        const QVector<int> &positions = timeline.positions;
+        frame = std::lower_bound(positions.begin(), positions.end(), pos) - positions.begin();
+
+        if (frame == positions.size()
+            or (frame > 0 and pos - positions.at(frame - 1) < positions.at(frame) - pos))
+            --frame;
 
-        //draw text
-        painter.drawText(centerRight, "OFF");
+        if (frame >= 0 and qAbs(positions.at(frame) - pos) > PRERENDER_MAX_ERROR)
+            frame = -1;
     }
+
+    if (frame >= 0)
+        painter.drawImage(paintCache.trackRect.topLeft(), timeline.frames.at(frame));
     else
+        paintTrack(painter, paintCache, pos, currentColor, isCustomWindow, !running and !dragging);
+
+#ifdef SLIDER_ALLOCATION_COUNTER
+    painter.end();
+
+    // the first frames after a resize fill the glyph and path caches
+    allocations = allocationCount() - allocations - painterAllocations;
+    if (steadyFrames < ALLOCATION_WARMUP_FRAMES)
     {
-        //draw big ellipse
-        painter.setPen(QPen(currentColor));
-        painter.setBrush(QBrush(currentColor));
+        ++steadyFrames;
+    }
+    else if (allocations)
+    {
+        steadyAllocations += allocations;
+        qWarning("SliderWidget: %llu heap allocations in a steady state frame (and %llu in QPainter::begin())",
+                 allocations, painterAllocations);
+    }
+#endif
+}
 
-        painter.drawEllipse(centerLeft, radius, radius);
-        painter.drawEllipse(centerRight, radius, radius);
-        painter.drawRect(centerLeft.x(), centerLeft.y() - radius, radius * 2 , radius * 2);
+#ifdef SLIDER_ALLOCATION_COUNTER
+quint64 SliderWidget::steadyStateAllocations() const
+{
+    return steadyAllocations;
+}
+#endif
 
-        //draw small circle inside
-        painter.setPen(QPen(Qt::white));
-        painter.setBrush(QBrush(Qt::white));
-        painter.drawEllipse(QPoint(pos, centerRight.y()), int(radius - scaleFactor), int(radius - scaleFactor));
+void SliderPaintCache::update(const QSize &size, QFont font)
+{
+    this->size = size;
 
-        if (animation->state() == QPropertyAnimation::Running)
-            return;
+    int width = size.width();
+    int height = size.height();
+    int radius = height / 4;
+    float scaleFactor = float(width)/63.2;
 
-        //draw text
-        painter.drawText(centerLeft, "ON");
-    }
+    font.setPointSize(qMax(1, int(scaleFactor)));
+    captionFont = font;
+    caption.setText(QStringLiteral(SLIDER_CAPTION_TEXT));
+    caption.setPerformanceHint(QStaticText::AggressiveCaching);
+    caption.prepare(QTransform(), captionFont);
+
+    //centered in the line below the slider
+    QRect rect(0, 3 * height / 4 + radius / 2, width, QFontMetrics( captionFont ).height());
+    captionPos = QPointF(rect.x() + (rect.width() - caption.size().width()) / 2,
+                         rect.y() + (rect.height() - caption.size().height()) / 2);
+
+    font.setPointSize(qMax(1, int(1.5*int(scaleFactor))));
+    stateFont = font;
+    onText.setText(QStringLiteral(SLIDER_ON_TEXT));
+    onText.setPerformanceHint(QStaticText::AggressiveCaching);
+    onText.prepare(QTransform(), stateFont);
+    offText.setText(QStringLiteral(SLIDER_OFF_TEXT));
+    offText.setPerformanceHint(QStaticText::AggressiveCaching);
+    offText.prepare(QTransform(), stateFont);
+
+    //the state text is drawn from its baseline
+    stateAscent = QFontMetrics( stateFont ).ascent();
+
+    //both ends of the track, the only part that changes during the animation
+    trackRect = QRect(width / 2 - 2 * radius, height / 2 - radius, 4 * radius, 2 * radius);
+
+    captionPen = QPen(QColor(220, 220, 220));
+    trackPen = QPen(COLOR_START);
+    trackBrush = QBrush(COLOR_START);
+    knobPen = QPen(Qt::white);
+    knobBrush = QBrush(Qt::white);
 }
 
-void SliderWidget::setPosition(int value)
+void SliderWidget::paintCaption(QPainter &painter, SliderPaintCache &cache)
 {
-    pos = value;
+    painter.setFont(cache.captionFont);
+    painter.setPen(cache.captionPen);
+    painter.drawStaticText(cache.captionPos, cache.caption);
+}
 
-    int diff = centerRight.x() - centerLeft.x();
-    float someValue = float(value - centerLeft.x()) / diff;
+void SliderWidget::paintTrack(QPainter &painter, SliderPaintCache &cache, int pos, const QColor &color,
+                              bool customWindow, bool drawState)
+{
+    int width = cache.size.width();
+    int height = cache.size.height();
+
+    int radius = height / 4;
+
+    QPoint centerLeft(width / 2 - radius, height / 2);
+    QPoint centerRight(width / 2 + radius, height / 2);
+    float scaleFactor = float(width)/63.2;
+
+    //draw big ellipse, the pen and brush are only recolored so they are not reallocated
+    cache.trackPen.setColor(color);
+    cache.trackBrush.setColor(color);
+    painter.setPen(cache.trackPen);
+    painter.setBrush(cache.trackBrush);
+
+    painter.drawEllipse(centerLeft, radius, radius);
+    painter.drawEllipse(centerRight, radius, radius);
+    painter.drawRect(centerLeft.x(), centerLeft.y() - radius, radius * 2 , radius * 2);
+
+    //draw small circle inside
+    painter.setPen(cache.knobPen);
+    painter.setBrush(cache.knobBrush);
+    painter.drawEllipse(QPoint(pos, centerLeft.y()), int(radius - scaleFactor), int(radius - scaleFactor));
+
+    if (!drawState)
+        return;
+
+    //draw text
+    painter.setFont(cache.stateFont);
+    if (customWindow)
+        painter.drawStaticText(centerLeft.x(), centerLeft.y() - cache.stateAscent, cache.onText);
+    else
+        painter.drawStaticText(centerRight.x(), centerRight.y() - cache.stateAscent, cache.offText);
+}
 
+QColor SliderWidget::colorAt(float progress)
+{
     int r, g, b;
 
     if (COLOR_START.red() > COLOR_END.red())
     {
-        r = (1-someValue) * (COLOR_START.red() - COLOR_END.red()) + COLOR_END.red();
+        r = (1-progress) * (COLOR_START.red() - COLOR_END.red()) + COLOR_END.red();
     }
     else
     {
-        r = (1-someValue) * (-COLOR_START.red() + COLOR_END.red()) + COLOR_START.red();
+        r = (1-progress) * (-COLOR_START.red() + COLOR_END.red()) + COLOR_START.red();
     }
 
     if (COLOR_START.green() > COLOR_END.green())
     {
-        g = (1-someValue) * (COLOR_START.green() - COLOR_END.green()) + COLOR_END.green();
+        g = (1-progress) * (COLOR_START.green() - COLOR_END.green()) + COLOR_END.green();
     }
     else
     {
-        g = (1-someValue) * (-COLOR_START.green() + COLOR_END.green()) + COLOR_START.green();
+        g = (1-progress) * (-COLOR_START.green() + COLOR_END.green()) + COLOR_START.green();
     }
 
     if (COLOR_START.blue() > COLOR_END.blue())
     {
-        b = (1-someValue) * (COLOR_START.blue() - COLOR_END.blue()) + COLOR_END.blue();
+        b = (1-progress) * (COLOR_START.blue() - COLOR_END.blue()) + COLOR_END.blue();
     }
     else
     {
-        b = (1-someValue) * (-COLOR_START.blue() + COLOR_END.blue()) + COLOR_START.blue();
+        b = (1-progress) * (-COLOR_START.blue() + COLOR_END.blue()) + COLOR_START.blue();
     }
 
     if (r < 0) r=0;
     if (g < 0) g=0;
     if (b < 0) b=0;
 
-    currentColor = QColor(r, g, b);
+    return QColor(r, g, b);
+}
+
+SliderTimeline SliderWidget::renderTimeline(QSize size, qreal dpr, QFont font)
+{
+    SliderTimeline timeline;
+    timeline.size = size;
+    timeline.dpr = dpr;
+
+    int radius = size.height() / 4;
+    int left = size.width() / 2 - radius;
+    int diff = radius * 2;
+
+    SliderPaintCache cache;
+    cache.update(size, font);
+
+    //evenly spaced positions, so retargeted and off-tick frames are as close as the canonical ones
+    int step = qMax(1, (diff + PRERENDER_MAX_FRAMES - 2) / (PRERENDER_MAX_FRAMES - 1));
+
+    for (int offset = 0; offset < diff + step; offset += step)
+    {
+        int pos = left + qMin(offset, diff);
+
+        QImage frame(cache.trackRect.size() * dpr, QImage::Format_ARGB32_Premultiplied);
+        frame.setDevicePixelRatio(dpr);
+        frame.fill(Qt::transparent);
+
+        QPainter painter(&frame);
+        painter.translate(-cache.trackRect.topLeft());
+        paintTrack(painter, cache, pos, colorAt(diff ? float(pos - left) / diff : 0), false, false);
+        painter.end();
 
-    this->repaint();
+        timeline.positions.append(pos);
+        timeline.frames.append(frame);
+    }
+
+    return timeline;
 }
 
-void SliderWidget::getMaxScreen()
+void SliderWidget::setPrerenderEnabled(bool enable)
 {
-    if (isCustomWindow)
+    prerenderEnabled = enable and QFontDatabase::supportsThreadedFontRendering();
+    timeline = SliderTimeline();
+
+    if (prerenderEnabled)
+        schedulePrerender();
+}
+
+void SliderWidget::schedulePrerender()
+{
+    if (!prerenderEnabled or width() <= 0 or height() <= 0)
+        return;
+
+    //only one render at a time, the last requested size is rendered when it finishes
+    if (prerenderWatcher->isRunning())
     {
-        pos = centerRight.x();
-        currentColor = COLOR_END;
+        prerenderPending = true;
+        return;
     }
-    else
+
+    prerenderPending = false;
+    prerenderWatcher->setFuture(QtConcurrent::run(&SliderWidget::renderTimeline, size(), devicePixelRatioF(), *myFont));
+}
+
+void SliderWidget::prerenderFinished()
+{
+    if (prerenderPending)
     {
-        pos = centerLeft.x();
-        currentColor = COLOR_START;
+        schedulePrerender();
+        return;
     }
-    repaint();
+
+    SliderTimeline result = prerenderWatcher->result();
+
+    if (prerenderEnabled and result.size == size() and result.dpr == devicePixelRatioF() and !result.frames.isEmpty())
+        timeline = result;
+}
+
+void SliderWidget::setPosition(int value)
+{
+    applyPosition(value);
+
+    update();
+}
+
+void SliderWidget::getMaxScreen()
+{
+    // a running animation or drag already ends on the state position
+    if (animation->state() == QPropertyAnimation::Running or dragging)
+        return;
+
+    int target = isCustomWindow ? centerRight.x() : centerLeft.x();
+    QColor color = isCustomWindow ? COLOR_END : COLOR_START;
+
+    if (pos == target and currentColor == color)
+        return;
+
+    pos = target;
+    currentColor = color;
+    update();
 }
 
 void SliderWidget::canChangeState()
 {
     timer->stop();
+
+    if (committedState == isCustomWindow)
+        return;
+
+    committedState = isCustomWindow;
     emit customWindowEnable(isCustomWindow);
 }
 
@@ -183,46 +424,216 @@ int SliderWidget::position() const
     return pos;
 }
 
+void SliderWidget::setCommitImmediately(bool enable)
+{
+    commitImmediately = enable;
+}
+
 void SliderWidget::animate(bool checked)
 {
     animation->setDirection(checked ? QPropertyAnimation::Forward : QPropertyAnimation::Backward);
     animation->start();
 }
 
-void SliderWidget::mousePressEvent(QMouseEvent *event)
+void SliderWidget::moveTo(bool state)
 {
-    if (animation->state() == QPropertyAnimation::Running)
+    firstRun = false;
+    isCustomWindow = state;
+
+    int target = state ? centerRight.x() : centerLeft.x();
+    int diff = qMax(1, centerRight.x() - centerLeft.x());
+    int distance = target - pos;
+
+    // the knob velocity is only meaningful if it moved during the last frames
+    qreal velocity = knobClock.elapsed() - lastKnobTime > 2 * PRERENDER_FRAME_TIME ? 0 : knobVelocity;
+
+    animation->stop();
+
+    if (distance == 0)
+    {
+        update();
+    }
+    else
+    {
+        int duration = qMax(ANIMATION_MIN_TIME, ANIMATION_TIME * qAbs(distance) / diff);
+
+        if (velocity == 0)
+        {
+            animation->setEasingCurve(QEasingCurve::InOutExpo);
+        }
+        else
+        {
+            // start with the current knob velocity and ease out on the target
+            qreal slope = velocity * duration / distance;
+            QEasingCurve curve(QEasingCurve::BezierSpline);
+            curve.addCubicBezierSegment(QPointF(1.0 / 3, slope / 3), QPointF(2.0 / 3, 1), QPointF(1, 1));
+            animation->setEasingCurve(curve);
+        }
+
+        animation->setStartValue(pos);
+        animation->setEndValue(target);
+        animation->setDuration(duration);
+
+        animate(true);
+    }
+
+    // the window follows when the knob lands, a retargeted animation is shorter than ANIMATION_TIME
+    if (commitImmediately)
+        canChangeState();
+    else
+        timer->start(distance == 0 ? 0 : animation->duration());
+}
+
+void SliderWidget::requestState(bool state)
+{
+    // only the first request since the last drain schedules a frame, the frame drains
+    if (requestedStates.push(state))
+        QMetaObject::invokeMethod(this, "update", Qt::QueuedConnection);
+}
+
+void SliderWidget::drainRequestedStates()
+{
+    bool state;
+
+    if (!requestedStates.takeLatest(&state))
+        return;
+
+    // the knob stays under the mouse, the state is applied on release
+    if (dragging)
+    {
+        stateHeld = true;
+        heldState = state;
         return;
+    }
+
+    if (state != isCustomWindow)
+        moveTo(state);
+}
+
+bool SliderWidget::knobContains(const QPoint &point) const
+{
+    int radius = height() / 4;
+    QPoint d = point - QPoint(pos, height() / 2);
 
+    return d.x() * d.x() + d.y() * d.y() <= radius * radius;
+}
+
+void SliderWidget::applyPosition(int value)
+{
+    value = qBound(centerLeft.x(), value, centerRight.x());
+
+    qint64 now = knobClock.elapsed();
+    if (now > lastKnobTime)
+        knobVelocity = qreal(value - pos) / (now - lastKnobTime);
+    lastKnobTime = now;
+
+    pos = value;
+
+    int diff = centerRight.x() - centerLeft.x();
+    currentColor = colorAt(diff ? float(value - centerLeft.x()) / diff : 0);
+}
+
+void SliderWidget::mousePressEvent(QMouseEvent *event)
+{
     if (event->button() == Qt::LeftButton)
     {
-        firstRun = false;
-        isCustomWindow = !isCustomWindow;
-        if (isCustomWindow)
+        if (knobContains(event->pos()))
         {
-            animation->setStartValue(centerLeft.x());
-            animation->setEndValue(centerRight.x());
+            // grab the knob, also in the middle of an animation, the state is committed on release
+            animation->stop();
+            timer->stop();
+            firstRun = false;
+            dragging = true;
+            dragMoved = false;
+            dragPressX = event->x();
+            dragOffset = pos - event->x();
+            dragX = event->x();
         }
         else
         {
-            animation->setStartValue(centerRight.x());
-            animation->setEndValue(centerLeft.x());
+            moveTo(!isCustomWindow);
         }
-        animation->setDuration(ANIMATION_TIME);
-        animation->setEasingCurve(QEasingCurve::InOutExpo);
+    }
+    update();
+}
 
-        animate(true);
+void SliderWidget::mouseMoveEvent(QMouseEvent *event)
+{
+    if (!dragging)
+        return;
+
+    if (qAbs(event->x() - dragPressX) >= QApplication::startDragDistance())
+        dragMoved = true;
+
+    // only the last position is used, once per painted frame
+    dragX = event->x();
+    if (!dragUpdatePending)
+    {
+        dragUpdatePending = true;
+        update();
+    }
+}
+
+void SliderWidget::mouseReleaseEvent(QMouseEvent *event)
+{
+    if (!dragging or event->button() != Qt::LeftButton)
+        return;
+
+    dragging = false;
+
+    if (dragUpdatePending)
+    {
+        dragUpdatePending = false;
+        applyPosition(dragX + dragOffset);
+    }
 
-        // tigger update on animation finished
-        connect(animation, SIGNAL(finished()), this, SLOT(update()));
+    bool state = dragMoved ? pos > (centerLeft.x() + centerRight.x()) / 2 : !isCustomWindow;
 
-        timer->start();
+    // a state requested during the drag is newer than the drag
+    if (stateHeld)
+    {
+        stateHeld = false;
+        state = heldState;
     }
-    repaint();
+
+    moveTo(state);
+}
+
+void SliderWidget::setCustomWindow(bool state)
+{
+    if (animation->state() == QPropertyAnimation::Running)
+        animation->stop();
+
+    firstRun = false;
+    dragging = false;
+    dragUpdatePending = false;
+    stateHeld = false;
+    isCustomWindow = state;
+    committedState = state;
+    getMaxScreen();
 }
 
 void SliderWidget::resizeEvent(QResizeEvent *)
 {
+    int radius = height() / 4;
+    centerLeft = QPoint(width() / 2 - radius, height() / 2);
+    centerRight = QPoint(width() / 2 + radius, height() / 2);
+
+    timeline = SliderTimeline();
+    if (prerenderEnabled)
+        prerenderTimer->start();
+
+    if (animation->state() == QPropertyAnimation::Running)
+    {
+        // keep the animation going towards the new state position
+        animation->setEndValue(isCustomWindow ? centerRight.x() : centerLeft.x());
+        return;
+    }
+
+    dragging = false;
+    dragUpdatePending = false;
+
+    // the resize itself schedules the paint
     if (isCustomWindow)
     {
         pos = centerRight.x();
@@ -233,5 +644,12 @@ void SliderWidget::resizeEvent(QResizeEvent *)
         pos = centerLeft.x();
         currentColor = COLOR_START;
     }
-    repaint();
+
+    // the resize ended the drag before its release
+    if (stateHeld)
+    {
+        stateHeld = false;
+        if (heldState != isCustomWindow)
+            moveTo(heldState);
+    }
 }
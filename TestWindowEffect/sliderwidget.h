@@ -3,14 +3,71 @@
 
 #include <QWidget>
 #include <QPropertyAnimation>
+#include <QFutureWatcher>
+#include <QImage>
+#include <QVector>
+#include <QElapsedTimer>
+#include <QStaticText>
+#include <QPen>
+#include <QBrush>
 
+#include "togglestatequeue.h"
 
+class QPainter;
+class QTimer;
 
 const int ANIMATION_TIME = 600; //in miliseconds
+const int ANIMATION_MIN_TIME = 150; //in miliseconds, for retargeted animations
 const QColor COLOR_START = QColor(205, 186, 150);
 const QColor COLOR_END = QColor(102, 205, 0);
+const int PRERENDER_FRAME_TIME = 16; //in miliseconds
+const int PRERENDER_DELAY = 250; //in miliseconds, after the last resize
+const int PRERENDER_MAX_FRAMES = 64; //per widget size, the step between knob positions grows above
+const int PRERENDER_MAX_ERROR = 1; //in pixels, a frame further from the knob is painted live
 
+/**
+ * Frames of the track of the toggle animation rendered for one widget size, at evenly spaced knob
+ * positions in increasing order.
+ */
+struct SliderTimeline
+{
+    QSize size;
+    qreal dpr;
+    QVector<int> positions;
+    QVector<QImage> frames;
+
+    SliderTimeline() : dpr(0) {}
+};
+
+
+/**
+ * Fonts, texts, pens and brushes of the slider for one widget size, so a frame is painted without
+ * allocating them again.
+ */
+struct SliderPaintCache
+{
+    QSize size;
+    QFont captionFont;
+    QFont stateFont;
+    QStaticText caption;
+    QStaticText onText;
+    QStaticText offText;
+    QPointF captionPos;
+    QRect trackRect;
+    int stateAscent;
+    QPen captionPen;
+    QPen trackPen;
+    QBrush trackBrush;
+    QPen knobPen;
+    QBrush knobBrush;
+
+    SliderPaintCache() : stateAscent(0) {}
+    void update(const QSize &size, QFont font);
+};
 
+#ifdef SLIDER_ALLOCATION_COUNTER
+const int ALLOCATION_WARMUP_FRAMES = 3;
+#endif
 
 class SliderWidget : public QWidget
 {
@@ -23,15 +80,48 @@ public:
 
     void paintEvent(QPaintEvent *);
     void mousePressEvent(QMouseEvent *event);
+    void mouseMoveEvent(QMouseEvent *event);
+    void mouseReleaseEvent(QMouseEvent *event);
     void resizeEvent(QResizeEvent *);
 
     int position() const;
 
+    /**
+     * Off by default. Renders the track frames of the toggle animation on a worker thread once a
+     * resize has settled, so the animation only blits them. The frames are taken at evenly spaced
+     * knob positions, at most PRERENDER_MAX_FRAMES images of 4 x 2 track radius are kept. A knob
+     * position further than PRERENDER_MAX_ERROR from every frame, and the animation until the
+     * frames are ready, are painted live.
+     */
+    void setPrerenderEnabled(bool enable);
+    /**
+     * Emits customWindowEnable() as soon as the slider is toggled instead of after ANIMATION_TIME,
+     * the animation catches up with the window.
+     */
+    void setCommitImmediately(bool enable);
+    /**
+     * Requests a toggle state from any thread. The requests are applied at the start of the next
+     * frame of the slider, only the newest one is animated.
+     */
+    void requestState(bool state);
+#ifdef SLIDER_ALLOCATION_COUNTER
+    /**
+     * Heap allocations of the frames painted after the warm up frames of the last resize, besides
+     * the one of QPainter::begin(). Only built with CONFIG+=alloc_counter.
+     */
+    quint64 steadyStateAllocations() const;
+#endif
+
 public slots:
     void animate(bool);
     void setPosition(int value);
     void getMaxScreen();
     void canChangeState();
+    void setCustomWindow(bool state);
+
+private slots:
+    void schedulePrerender();
+    void prerenderFinished();
 
 signals:
     void customWindowEnable(bool state);
@@ -46,6 +136,50 @@ private:
     QPoint centerLeft, centerRight;
     bool isCustomWindow;
     QPropertyAnimation *animation;
+
+    bool prerenderEnabled;
+    bool prerenderPending;
+    SliderTimeline timeline;
+    QFutureWatcher<SliderTimeline> *prerenderWatcher;
+    QTimer *prerenderTimer;
+
+    ToggleStateQueue requestedStates;
+    bool committedState;
+    bool commitImmediately;
+    bool dragging;
+    bool stateHeld; //requested while dragging, applied on release
+    bool heldState;
+    bool dragMoved;
+    bool dragUpdatePending;
+    int dragPressX;
+    int dragOffset;
+    int dragX;
+    QElapsedTimer knobClock;
+    qint64 lastKnobTime;
+    qreal knobVelocity; //pixels per milisecond
+
+    /**
+     * Toggles to the state, animating from the current knob position and velocity.
+     */
+    void moveTo(bool state);
+    /**
+     * Applies the newest requested state, once per painted frame.
+     */
+    void drainRequestedStates();
+    void applyPosition(int value);
+    bool knobContains(const QPoint &point) const;
+    SliderPaintCache paintCache;
+#ifdef SLIDER_ALLOCATION_COUNTER
+    int steadyFrames;
+    quint64 steadyAllocations;
+#endif
+
+    static void paintCaption(QPainter &painter, SliderPaintCache &cache);
+    static void paintTrack(QPainter &painter, SliderPaintCache &cache, int pos, const QColor &color,
+                           bool customWindow, bool drawState);
+    static QColor colorAt(float progress);
+    static QString fontFamily();
+    static SliderTimeline renderTimeline(QSize size, qreal dpr, QFont font);
 };
 
 #endif // SLIDERWIDGET_H
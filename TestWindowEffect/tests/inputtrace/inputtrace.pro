@@ -0,0 +1,5 @@
+TARGET = tst_inputtrace
+
+include(../tests.pri)
+
+SOURCES += tst_inputtrace.cpp
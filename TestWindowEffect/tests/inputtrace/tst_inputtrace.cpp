@@ -0,0 +1,134 @@
+#include <QtTest>
+#include "customwindow.h"
+#include "inputtrace.h"
+#include "windowsession.h"
+
+class TestInputTrace : public QObject
+{
+    Q_OBJECT
+
+    private slots:
+        void initTestCase();
+        void edgeDragRoundTrip();
+        void rejectsTruncatedHeader();
+        void rejectsUnknownEvent();
+
+    private:
+        QTemporaryDir dir;
+
+        static void send(QWidget *window, QEvent::Type type, const QPoint &pos, Qt::MouseButton button,
+                         Qt::MouseButtons buttons);
+        void writeHeader(QDataStream &stream);
+};
+
+void TestInputTrace::initTestCase()
+{
+    QVERIFY(dir.isValid());
+
+    // the replay must not depend on nor change dialogs.ini
+    WindowSession::instance()->setPersistent(false);
+}
+
+void TestInputTrace::send(QWidget *window, QEvent::Type type, const QPoint &pos, Qt::MouseButton button,
+                          Qt::MouseButtons buttons)
+{
+    QMouseEvent event(type, pos, window->mapToGlobal(pos), button, buttons, Qt::NoModifier);
+    QApplication::sendEvent(window, &event);
+    QCoreApplication::processEvents();
+}
+
+void TestInputTrace::writeHeader(QDataStream &stream)
+{
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream << INPUT_TRACE_MAGIC << INPUT_TRACE_VERSION
+           << qint32(100) << qint32(100) << qint32(640) << qint32(480) << quint8(INPUT_TRACE_CUSTOM_MODE);
+}
+
+void TestInputTrace::edgeDragRoundTrip()
+{
+    QString fileName = dir.filePath("edgedrag.trace");
+    QRect recorded;
+
+    {
+        CustomWindow window(0, "record");
+        window.setSystemMoveResize(false);
+        window.setCustomMode(true);
+        window.setGeometry(100, 100, 640, 480);
+        window.show();
+        QVERIFY(QTest::qWaitForWindowExposed(&window));
+
+        InputTraceRecorder recorder(&window);
+        QVERIFY(recorder.start(fileName));
+
+        // grabs the right border and drags it to the right
+        QPoint edge(window.width() - 2, window.height() / 2);
+        send(&window, QEvent::MouseMove, edge, Qt::NoButton, Qt::NoButton);
+        send(&window, QEvent::MouseButtonPress, edge, Qt::LeftButton, Qt::LeftButton);
+        for (int step = 1; step <= 20; ++step)
+            send(&window, QEvent::MouseMove, edge + QPoint(step * 8, 0), Qt::NoButton, Qt::LeftButton);
+        send(&window, QEvent::MouseButtonRelease, edge + QPoint(160, 0), Qt::LeftButton, Qt::NoButton);
+
+        recorder.stop();
+        recorded = window.geometry();
+    }
+
+    QVERIFY(recorded.width() > 640);
+
+    InputTraceReplayer replayer;
+    QVERIFY(replayer.load(fileName));
+
+    CustomWindow window(0, "replay");
+    window.setSystemMoveResize(false);
+    window.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+
+    replayer.replay(&window, InputTraceReplayer::MaximumSpeed);
+
+    QVERIFY(window.isCustomMode());
+    QCOMPARE(window.geometry(), recorded);
+}
+
+void TestInputTrace::rejectsTruncatedHeader()
+{
+    QString fileName = dir.filePath("truncated.trace");
+
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QDataStream stream(&file);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream << INPUT_TRACE_MAGIC << INPUT_TRACE_VERSION << qint32(100);
+    file.close();
+
+    InputTraceReplayer replayer;
+    QVERIFY(!replayer.load(fileName));
+}
+
+void TestInputTrace::rejectsUnknownEvent()
+{
+    QString fileName = dir.filePath("unknown.trace");
+
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QDataStream stream(&file);
+    writeHeader(stream);
+    stream << quint32(0) << quint8(42) << quint8(0) << quint8(0) << quint8(0)
+           << qint16(0) << qint16(0) << qint16(0) << qint16(0);
+    file.close();
+
+    InputTraceReplayer replayer;
+    QVERIFY(!replayer.load(fileName));
+}
+
+int main(int argc, char *argv[])
+{
+    // the trace is replayed with synthetic events, it needs no display
+    if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+    TestInputTrace test;
+
+    return QTest::qExec(&test, argc, argv);
+}
+
+#include "tst_inputtrace.moc"
@@ -0,0 +1,8 @@
+TARGET = tst_sliderallocations
+
+# counts the heap allocations of the slider frames
+CONFIG += alloc_counter
+
+include(../tests.pri)
+
+SOURCES += tst_sliderallocations.cpp
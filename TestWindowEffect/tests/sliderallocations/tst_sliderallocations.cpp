@@ -0,0 +1,79 @@
+#include <QtTest>
+#include "sliderwidget.h"
+#include "allocationcounter.h"
+
+class TestSliderAllocations : public QObject
+{
+    Q_OBJECT
+
+    private slots:
+        void counterSeesQtAllocations();
+        void steadyFramesDoNotAllocate_data();
+        void steadyFramesDoNotAllocate();
+
+    private:
+        void toggle(SliderWidget &slider, bool state);
+};
+
+/**
+ * @brief toggle Animates the slider to the state and paints every frame of the animation.
+ */
+void TestSliderAllocations::toggle(SliderWidget &slider, bool state)
+{
+    slider.requestState(state);
+    QCoreApplication::processEvents();
+
+    QElapsedTimer clock;
+    clock.start();
+    while (clock.elapsed() < ANIMATION_TIME + 100)
+    {
+        slider.repaint();
+        QTest::qWait(PRERENDER_FRAME_TIME);
+    }
+}
+
+void TestSliderAllocations::counterSeesQtAllocations()
+{
+    // QString and QVector data is allocated with malloc and realloc, not operator new
+    quint64 allocations = allocationCount();
+    QString text = QString::fromLatin1("USE SLIDER TO SWITCH WINDOW STATES");
+    QVector<int> values;
+    values.append(text.size());
+    QVERIFY(allocationCount() - allocations >= 2);
+}
+
+void TestSliderAllocations::steadyFramesDoNotAllocate_data()
+{
+    QTest::addColumn<bool>("prerender");
+
+    QTest::newRow("live") << false;
+    QTest::newRow("prerendered") << true;
+}
+
+void TestSliderAllocations::steadyFramesDoNotAllocate()
+{
+    QFETCH(bool, prerender);
+
+    SliderWidget slider;
+    slider.setPrerenderEnabled(prerender);
+    slider.resize(400, 200);
+    slider.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&slider));
+
+    // the pre-rendered frames are ready once the resize settled
+    QTest::qWait(PRERENDER_DELAY + 500);
+
+    // a first round trip fills the glyph, path and image caches of both states
+    toggle(slider, true);
+    toggle(slider, false);
+    quint64 warmup = slider.steadyStateAllocations();
+
+    toggle(slider, true);
+    toggle(slider, false);
+
+    QCOMPARE(slider.steadyStateAllocations() - warmup, quint64(0));
+}
+
+QTEST_MAIN(TestSliderAllocations)
+
+#include "tst_sliderallocations.moc"
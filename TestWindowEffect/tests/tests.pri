@@ -0,0 +1,8 @@
+# Common settings of the test cases, each one builds the application sources it tests
+
+QT       += core gui testlib
+
+CONFIG   += testcase
+TEMPLATE = app
+
+include(../TestWindowEffect.pri)
@@ -0,0 +1,8 @@
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    wakeupcounter \
+    sliderallocations \
+    togglestatequeue \
+    inputtrace \
+    windowshapehints
@@ -0,0 +1,5 @@
+TARGET = tst_togglestatequeue
+
+include(../tests.pri)
+
+SOURCES += tst_togglestatequeue.cpp
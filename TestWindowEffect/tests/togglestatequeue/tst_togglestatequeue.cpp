@@ -0,0 +1,196 @@
+#include <QtTest>
+#include <QtConcurrent>
+#include "togglestatequeue.h"
+#include "sliderwidget.h"
+
+/**
+ * @brief PUSHES_PER_PRODUCER States pushed by every producer thread of the stress test.
+ */
+#define PUSHES_PER_PRODUCER 200000
+/**
+ * @brief SLIDER_PUSHES_PER_PRODUCER States requested from every producer thread of the slider test.
+ */
+#define SLIDER_PUSHES_PER_PRODUCER 20000
+
+/**
+ * @brief The FrameChecker class fails if more than one animation is started between two frames.
+ */
+class FrameChecker : public QObject
+{
+    public:
+        int starts;
+        int startsAtLastFrame;
+        int frames;
+        int worstFrame;
+
+        FrameChecker() : starts(0), startsAtLastFrame(0), frames(0), worstFrame(0) {}
+
+        void frameDone()
+        {
+            worstFrame = qMax(worstFrame, starts - startsAtLastFrame);
+            startsAtLastFrame = starts;
+        }
+
+    protected:
+        bool eventFilter(QObject *obj, QEvent *e)
+        {
+            // the drain runs in the paint event, after the filter
+            if (e->type() == QEvent::Paint)
+            {
+                frameDone();
+                ++frames;
+            }
+
+            return QObject::eventFilter(obj, e);
+        }
+};
+
+class TestToggleStateQueue : public QObject
+{
+    Q_OBJECT
+
+    private slots:
+        void emptyQueue();
+        void newestStateWins();
+        void multipleProducers();
+        void multipleProducersThroughSlider();
+};
+
+/**
+ * @brief produce Pushes alternating states and ends with true, returns the number of wake ups.
+ */
+static int produce(ToggleStateQueue *queue, int seed)
+{
+    int wakeups = 0;
+    for (int i = 0; i < PUSHES_PER_PRODUCER; ++i)
+    {
+        bool state = i == PUSHES_PER_PRODUCER - 1 or (i + seed) % 2;
+        if (queue->push(state))
+            ++wakeups;
+    }
+
+    return wakeups;
+}
+
+/**
+ * @brief requestStates Requests alternating states and ends with true.
+ */
+static void requestStates(SliderWidget *slider, int seed)
+{
+    for (int i = 0; i < SLIDER_PUSHES_PER_PRODUCER; ++i)
+        slider->requestState(i == SLIDER_PUSHES_PER_PRODUCER - 1 or (i + seed) % 2);
+}
+
+void TestToggleStateQueue::emptyQueue()
+{
+    ToggleStateQueue queue;
+    bool state = false;
+
+    QVERIFY(!queue.takeLatest(&state));
+}
+
+void TestToggleStateQueue::newestStateWins()
+{
+    ToggleStateQueue queue;
+    bool state = false;
+
+    QVERIFY(queue.push(true));
+    QVERIFY(!queue.push(false));
+    QVERIFY(!queue.push(true));
+
+    QVERIFY(queue.takeLatest(&state));
+    QCOMPARE(state, true);
+    QVERIFY(!queue.takeLatest(&state));
+
+    QVERIFY(queue.push(false));
+    QVERIFY(queue.takeLatest(&state));
+    QCOMPARE(state, false);
+}
+
+void TestToggleStateQueue::multipleProducers()
+{
+    ToggleStateQueue queue;
+    int producers = qMax(4, QThread::idealThreadCount() * 2);
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(producers);
+
+    QList<QFuture<int> > futures;
+    for (int i = 0; i < producers; ++i)
+        futures.append(QtConcurrent::run(&pool, produce, &queue, i));
+
+    // the test thread is the consumer, it drains while the producers push
+    int takes = 0;
+    bool state = false;
+    bool last = false;
+    while (pool.activeThreadCount() > 0)
+    {
+        if (queue.takeLatest(&state))
+        {
+            ++takes;
+            last = state;
+        }
+    }
+    pool.waitForDone();
+
+    if (queue.takeLatest(&state))
+    {
+        ++takes;
+        last = state;
+    }
+
+    // every push that found the queue empty is matched by exactly one take
+    int wakeups = 0;
+    for (int i = 0; i < futures.size(); ++i)
+        wakeups += futures.at(i).result();
+
+    QCOMPARE(wakeups, takes);
+    QVERIFY(takes > 0);
+
+    // the newest push of all is the last state of one of the producers
+    QCOMPARE(last, true);
+    QVERIFY(!queue.takeLatest(&state));
+}
+
+void TestToggleStateQueue::multipleProducersThroughSlider()
+{
+    SliderWidget slider;
+    slider.resize(400, 200);
+    slider.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&slider));
+
+    QPropertyAnimation *animation = slider.findChild<QPropertyAnimation *>();
+    QVERIFY(animation);
+
+    FrameChecker checker;
+    slider.installEventFilter(&checker);
+    connect(animation, &QAbstractAnimation::stateChanged, [&checker](QAbstractAnimation::State state) {
+        if (state == QAbstractAnimation::Running)
+            ++checker.starts;
+    });
+
+    int producers = qMax(4, QThread::idealThreadCount() * 2);
+    QThreadPool pool;
+    pool.setMaxThreadCount(producers);
+
+    for (int i = 0; i < producers; ++i)
+        QtConcurrent::run(&pool, requestStates, &slider, i);
+
+    // the test thread paints the frames while the producers request
+    while (pool.activeThreadCount() > 0)
+        QCoreApplication::processEvents();
+    pool.waitForDone();
+
+    // the last request is drained by the next frame, then its animation lands
+    QTest::qWait(ANIMATION_TIME + 200);
+    checker.frameDone();
+
+    QVERIFY(checker.frames > 0);
+    QVERIFY(checker.starts > 0);
+    QCOMPARE(checker.worstFrame, 1);
+    QCOMPARE(slider.position(), slider.width() / 2 + slider.height() / 4);
+}
+
+QTEST_MAIN(TestToggleStateQueue)
+
+#include "tst_togglestatequeue.moc"
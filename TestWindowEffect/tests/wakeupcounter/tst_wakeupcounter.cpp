@@ -0,0 +1,97 @@
+#include <QtTest>
+#include "customwindow.h"
+#include "sliderwidget.h"
+#include "wakeupcounter.h"
+#include "windowsession.h"
+
+/**
+ * @brief IDLE_INTERVAL Time an idle window is watched, longer than every timer of the window.
+ */
+#define IDLE_INTERVAL 2000
+
+class TestWakeupCounter : public QObject
+{
+    Q_OBJECT
+
+    private slots:
+        void initTestCase();
+        void idleWindowDoesNotWakeUp_data();
+        void idleWindowDoesNotWakeUp();
+        void countsEveryWidget();
+};
+
+void TestWakeupCounter::initTestCase()
+{
+    // the tests must not depend on nor change dialogs.ini
+    WindowSession::instance()->setPersistent(false);
+}
+
+void TestWakeupCounter::idleWindowDoesNotWakeUp_data()
+{
+    QTest::addColumn<bool>("customMode");
+
+    QTest::newRow("standard") << false;
+    QTest::newRow("custom") << true;
+}
+
+void TestWakeupCounter::idleWindowDoesNotWakeUp()
+{
+    QFETCH(bool, customMode);
+
+    CustomWindow window;
+    window.setCustomMode(customMode);
+    window.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+
+    // the first frames and the deferred timers of the start up are not idle
+    QTest::qWait(IDLE_INTERVAL);
+
+    WakeupCounter counter;
+    counter.watch(&window);
+    QTest::qWait(IDLE_INTERVAL);
+
+    QList<QWidget *> widgets = window.findChildren<QWidget *>();
+    widgets.prepend(&window);
+    for (int i = 0; i < widgets.size(); ++i)
+    {
+        if (counter.wakeups(widgets.at(i)) != 0)
+        {
+            QString report;
+            QTextStream out(&report);
+            counter.printReport(out);
+            QFAIL(qPrintable(QString("%1 woke up while idle\n%2")
+                             .arg(widgets.at(i)->metaObject()->className()).arg(report)));
+        }
+    }
+
+    QCOMPARE(counter.totalWakeups(&window), 0);
+}
+
+void TestWakeupCounter::countsEveryWidget()
+{
+    CustomWindow window;
+    window.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+    QTest::qWait(IDLE_INTERVAL);
+
+    WakeupCounter counter;
+    counter.watch(&window);
+
+    SliderWidget *slider = window.findChild<SliderWidget *>();
+    QVERIFY(slider);
+    slider->repaint();
+
+    // the slider has its own count and the window total is the sum of its widgets
+    QVERIFY(counter.wakeups(slider) > 0);
+
+    QList<QWidget *> widgets = window.findChildren<QWidget *>();
+    int total = counter.wakeups(&window);
+    for (int i = 0; i < widgets.size(); ++i)
+        total += counter.wakeups(widgets.at(i));
+
+    QCOMPARE(counter.totalWakeups(&window), total);
+}
+
+QTEST_MAIN(TestWakeupCounter)
+
+#include "tst_wakeupcounter.moc"
@@ -0,0 +1,5 @@
+TARGET = tst_wakeupcounter
+
+include(../tests.pri)
+
+SOURCES += tst_wakeupcounter.cpp
@@ -0,0 +1,157 @@
+#include <QtTest>
+#include "customwindow.h"
+#include "windowsession.h"
+
+#ifdef HAVE_X11_SHAPE_HINTS
+#include <QX11Info>
+#include <cstdlib>
+#include <xcb/xcb.h>
+#include <xcb/shape.h>
+#endif
+
+class TestWindowShapeHints : public QObject
+{
+    Q_OBJECT
+
+    private slots:
+        void initTestCase();
+        void hintsFollowTheContent_data();
+        void hintsFollowTheContent();
+
+    private:
+        static QVector<QRect> opaqueRegion(QWidget *window);
+        static QVector<QRect> inputShape(QWidget *window);
+        static void verifyHints(QWidget *window, bool customMode);
+};
+
+void TestWindowShapeHints::initTestCase()
+{
+#ifndef HAVE_X11_SHAPE_HINTS
+    QSKIP("built without the X11 shape hints");
+#else
+    // run under Xvfb for example, the hints are only published on X11
+    if (QGuiApplication::platformName() != "xcb")
+        QSKIP("the shape hints are only published on the xcb platform");
+#endif
+
+    // the tests must not depend on nor change dialogs.ini
+    WindowSession::instance()->setPersistent(false);
+}
+
+QVector<QRect> TestWindowShapeHints::opaqueRegion(QWidget *window)
+{
+    QVector<QRect> rects;
+#ifdef HAVE_X11_SHAPE_HINTS
+    xcb_connection_t *connection = QX11Info::connection();
+    xcb_window_t id = xcb_window_t(window->internalWinId());
+
+    static const char name[] = "_NET_WM_OPAQUE_REGION";
+    xcb_intern_atom_reply_t *atom =
+            xcb_intern_atom_reply(connection, xcb_intern_atom(connection, true, sizeof(name) - 1, name), 0);
+    if (!atom)
+        return rects;
+
+    xcb_get_property_reply_t *reply =
+            xcb_get_property_reply(connection, xcb_get_property(connection, false, id, atom->atom,
+                                                                XCB_ATOM_CARDINAL, 0, 1024), 0);
+    free(atom);
+    if (!reply)
+        return rects;
+
+    const quint32 *data = static_cast<const quint32 *>(xcb_get_property_value(reply));
+    int count = xcb_get_property_value_length(reply) / int(sizeof(quint32));
+    for (int i = 0; i + 3 < count; i += 4)
+        rects.append(QRect(data[i], data[i + 1], data[i + 2], data[i + 3]));
+    free(reply);
+#else
+    Q_UNUSED(window);
+#endif
+    return rects;
+}
+
+QVector<QRect> TestWindowShapeHints::inputShape(QWidget *window)
+{
+    QVector<QRect> rects;
+#ifdef HAVE_X11_SHAPE_HINTS
+    xcb_connection_t *connection = QX11Info::connection();
+    xcb_window_t id = xcb_window_t(window->internalWinId());
+
+    xcb_shape_get_rectangles_reply_t *reply =
+            xcb_shape_get_rectangles_reply(connection, xcb_shape_get_rectangles(connection, id, XCB_SHAPE_SK_INPUT), 0);
+    if (!reply)
+        return rects;
+
+    const xcb_rectangle_t *data = xcb_shape_get_rectangles_rectangles(reply);
+    int count = xcb_shape_get_rectangles_rectangles_length(reply);
+    for (int i = 0; i < count; ++i)
+        rects.append(QRect(data[i].x, data[i].y, data[i].width, data[i].height));
+    free(reply);
+#else
+    Q_UNUSED(window);
+#endif
+    return rects;
+}
+
+void TestWindowShapeHints::verifyHints(QWidget *window, bool customMode)
+{
+    qreal dpr = window->devicePixelRatioF();
+    QRect bounds(0, 0, qRound(window->width() * dpr), qRound(window->height() * dpr));
+    int margin = qRound(PIXELS_TO_ACT * dpr);
+
+    QVector<QRect> opaque = opaqueRegion(window);
+    QCOMPARE(opaque.size(), 1);
+
+    if (customMode)
+    {
+        // the shadow around the content is translucent and does not take input
+        QVERIFY(bounds.contains(opaque.first()));
+        QVERIFY(opaque.first() != bounds);
+    }
+    else
+    {
+        QCOMPARE(opaque.first(), bounds);
+    }
+
+    QVector<QRect> input = inputShape(window);
+    QCOMPARE(input.size(), 1);
+    QCOMPARE(input.first(), opaque.first().adjusted(-margin, -margin, margin, margin) & bounds);
+}
+
+void TestWindowShapeHints::hintsFollowTheContent_data()
+{
+    QTest::addColumn<bool>("customMode");
+
+    QTest::newRow("standard") << false;
+    QTest::newRow("custom") << true;
+}
+
+void TestWindowShapeHints::hintsFollowTheContent()
+{
+    QFETCH(bool, customMode);
+
+    CustomWindow window;
+    window.setCustomMode(customMode);
+    window.resize(640, 480);
+    window.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+    QCoreApplication::processEvents();
+
+    verifyHints(&window, customMode);
+    QRect before = opaqueRegion(&window).value(0);
+
+    window.resize(800, 600);
+    QTRY_COMPARE(window.size(), QSize(800, 600));
+    QCoreApplication::processEvents();
+
+    verifyHints(&window, customMode);
+
+    // the content grows with the window, the shadow margins stay
+    qreal dpr = window.devicePixelRatioF();
+    QRect after = opaqueRegion(&window).value(0);
+    QCOMPARE(after.topLeft(), before.topLeft());
+    QCOMPARE(after.size(), before.size() + QSize(qRound(160 * dpr), qRound(120 * dpr)));
+}
+
+QTEST_MAIN(TestWindowShapeHints)
+
+#include "tst_windowshapehints.moc"
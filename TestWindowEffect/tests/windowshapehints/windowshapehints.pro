@@ -0,0 +1,5 @@
+TARGET = tst_windowshapehints
+
+include(../tests.pri)
+
+SOURCES += tst_windowshapehints.cpp
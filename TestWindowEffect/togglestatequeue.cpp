@@ -0,0 +1,24 @@
+#include "togglestatequeue.h"
+
+ToggleStateQueue::ToggleStateQueue() :
+    pending(Empty)
+{
+}
+
+bool ToggleStateQueue::push(bool state)
+{
+    // the producer that finds the slot empty wakes the consumer, the others only replace the state
+    return pending.fetchAndStoreOrdered(state ? On : Off) == Empty;
+}
+
+bool ToggleStateQueue::takeLatest(bool *state)
+{
+    int slot = pending.fetchAndStoreAcquire(Empty);
+
+    if (slot == Empty)
+        return false;
+
+    *state = slot == On;
+
+    return true;
+}
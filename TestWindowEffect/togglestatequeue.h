@@ -0,0 +1,37 @@
+#ifndef TOGGLESTATEQUEUE_H
+#define TOGGLESTATEQUEUE_H
+
+#include <QAtomicInt>
+
+/**
+ * @brief The ToggleStateQueue class is a lock-free multi-producer, single-consumer mailbox of
+ * requested toggle states. Only the newest state matters, so it is a single atomic slot: any
+ * thread swaps its state in, the consumer swaps the slot back to empty. It never allocates.
+ */
+class ToggleStateQueue
+{
+    public:
+        ToggleStateQueue();
+
+        /**
+         * @brief push Sets the requested state, from any thread. It supersedes a state not taken yet.
+         * @param state The requested state.
+         * @return True if the queue was empty, then the consumer has to be woken up.
+         */
+        bool push(bool state);
+        /**
+         * @brief takeLatest Empties the queue, from the consumer thread only.
+         * @param state Set to the newest pushed state.
+         * @return False if nothing was pushed since the last call.
+         */
+        bool takeLatest(bool *state);
+
+    private:
+        enum Slot { Empty = -1, Off = 0, On = 1 };
+
+        QAtomicInt pending;
+
+        Q_DISABLE_COPY(ToggleStateQueue)
+};
+
+#endif // TOGGLESTATEQUEUE_H
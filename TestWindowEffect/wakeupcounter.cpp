@@ -0,0 +1,160 @@
+#include "wakeupcounter.h"
+
+#include <QEvent>
+#include <QChildEvent>
+
+WakeupCounter::WakeupCounter(QObject *parent) :
+    QObject(parent)
+{
+}
+
+void WakeupCounter::watch(QObject *object)
+{
+    if (owners.contains(object))
+        return;
+
+    install(object, addCounter(object, -1));
+}
+
+int WakeupCounter::addCounter(QObject *widget, int parent)
+{
+    Counter counter;
+    counter.widget = widget;
+    counter.parent = parent;
+    counter.name = QString("%1 %2").arg(widget->metaObject()->className()).arg(counters.size() + 1);
+    counter.total = 0;
+    counter.sampled = 0;
+    counter.clock.start();
+    counters.append(counter);
+
+    return counters.size() - 1;
+}
+
+void WakeupCounter::install(QObject *object, int counter)
+{
+    if (owners.contains(object))
+        return;
+
+    // a child widget gets its own counter, timers and animations are counted with their widget
+    if (object->isWidgetType() and counters.at(counter).widget != object)
+        counter = addCounter(object, counter);
+
+    owners.insert(object, counter);
+    object->installEventFilter(this);
+    connect(object, SIGNAL(destroyed(QObject*)), this, SLOT(forget(QObject*)));
+
+    QObjectList children = object->children();
+    for (int i = 0; i < children.size(); ++i)
+        install(children.at(i), counter);
+}
+
+int WakeupCounter::wakeups(QObject *object) const
+{
+    int counter = owners.value(object, -1);
+    return counter == -1 ? 0 : counters.at(counter).total;
+}
+
+int WakeupCounter::totalWakeups(QObject *object) const
+{
+    int root = owners.value(object, -1);
+    if (root == -1)
+        return 0;
+
+    // child widgets are always added after their parent
+    int total = 0;
+    for (int i = root; i < counters.size(); ++i)
+    {
+        int counter = i;
+        while (counter > root)
+            counter = counters.at(counter).parent;
+
+        if (counter == root)
+            total += counters.at(i).total;
+    }
+
+    return total;
+}
+
+qreal WakeupCounter::wakeupsPerSecond(QObject *object)
+{
+    int counter = owners.value(object, -1);
+    return counter == -1 ? 0 : sample(counters[counter]);
+}
+
+qreal WakeupCounter::sample(Counter &counter)
+{
+    qint64 elapsed = counter.clock.restart();
+    int count = counter.total - counter.sampled;
+    counter.sampled = counter.total;
+
+    return elapsed > 0 ? count * 1000.0 / elapsed : 0;
+}
+
+QString WakeupCounter::path(int counter) const
+{
+    // a widget is added from its ChildAdded event, before its class and name are set
+    QObject *widget = counters.at(counter).widget;
+    QString name = counters.at(counter).name;
+    if (widget and !widget->objectName().isEmpty())
+        name = widget->objectName();
+    else if (widget)
+        name = QString("%1 %2").arg(widget->metaObject()->className()).arg(counter + 1);
+
+    int parent = counters.at(counter).parent;
+    return parent == -1 ? name : path(parent) + "/" + name;
+}
+
+void WakeupCounter::printReport(QTextStream &out)
+{
+    for (int i = 0; i < counters.size(); ++i)
+    {
+        int total = counters.at(i).total;
+        qreal rate = sample(counters[i]);
+
+        out << path(i) << ": " << total << " wakeups, " << rate << " per second" << "\n";
+    }
+}
+
+void WakeupCounter::forget(QObject *object)
+{
+    if (!owners.contains(object))
+        return;
+
+    int counter = owners.take(object);
+
+    // the class name is already lost here, the object name is still set
+    if (counters.at(counter).widget == object)
+    {
+        if (!object->objectName().isEmpty())
+            counters[counter].name = object->objectName();
+        counters[counter].widget = 0;
+    }
+}
+
+bool WakeupCounter::eventFilter(QObject *obj, QEvent *e)
+{
+    QHash<QObject *, int>::const_iterator owner = owners.constFind(obj);
+    if (owner == owners.constEnd())
+        return QObject::eventFilter(obj, e);
+
+    switch (e->type())
+    {
+        case QEvent::Timer:
+        case QEvent::Paint:
+        case QEvent::UpdateRequest:
+            ++counters[owner.value()].total;
+            break;
+        case QEvent::ChildAdded:
+            install(static_cast<QChildEvent *>(e)->child(), owner.value());
+            break;
+        case QEvent::ChildRemoved:
+            static_cast<QChildEvent *>(e)->child()->removeEventFilter(this);
+            disconnect(static_cast<QChildEvent *>(e)->child(), SIGNAL(destroyed(QObject*)), this, SLOT(forget(QObject*)));
+            forget(static_cast<QChildEvent *>(e)->child());
+            break;
+        default:
+            break;
+    }
+
+    return QObject::eventFilter(obj, e);
+}
@@ -0,0 +1,85 @@
+#ifndef WAKEUPCOUNTER_H
+#define WAKEUPCOUNTER_H
+
+#include <QObject>
+#include <QHash>
+#include <QVector>
+#include <QElapsedTimer>
+#include <QTextStream>
+
+/**
+ * @brief The WakeupCounter class counts the timer, paint and update request events received by
+ * watched widgets and their child objects. Every widget has its own count, which includes its
+ * non widget children (timers, animations), so the report shows which widget wakes up. It never
+ * wakes the application up itself, the rates are computed when they are read.
+ */
+class WakeupCounter : public QObject
+{
+    Q_OBJECT
+
+    public:
+        explicit WakeupCounter(QObject *parent = 0);
+        /**
+         * @brief watch Starts counting the wakeups of the object and of all its current and future
+         * children.
+         * @param object The object, usually a widget.
+         */
+        void watch(QObject *object);
+        /**
+         * @brief wakeups Returns the number of wakeups of a widget since it is watched, without the
+         * wakeups of its child widgets.
+         * @param object The watched object or one of its child widgets.
+         */
+        int wakeups(QObject *object) const;
+        /**
+         * @brief totalWakeups Returns the number of wakeups of a widget and of all its child widgets.
+         * @param object The watched object or one of its child widgets.
+         */
+        int totalWakeups(QObject *object) const;
+        /**
+         * @brief wakeupsPerSecond Returns the wakeups per second of a widget since the previous
+         * call, or since it is watched for the first call.
+         */
+        qreal wakeupsPerSecond(QObject *object);
+        /**
+         * @brief printReport Writes the wakeups of every widget watched, also the destroyed ones.
+         * @param out The output stream.
+         */
+        void printReport(QTextStream &out);
+
+    protected:
+        bool eventFilter(QObject *obj, QEvent *e);
+
+    private slots:
+        /**
+         * @brief forget Stops following a destroyed object, its counts are kept for the report.
+         */
+        void forget(QObject *object);
+
+    private:
+        struct Counter
+        {
+            QObject *widget;
+            /**
+             * @brief parent Index in counters of the parent widget, -1 for a watched object.
+             */
+            int parent;
+            QString name;
+            int total;
+            int sampled;
+            QElapsedTimer clock;
+        };
+
+        QVector<Counter> counters;
+        /**
+         * @brief owners Index in counters of every filtered object.
+         */
+        QHash<QObject *, int> owners;
+
+        int addCounter(QObject *widget, int parent);
+        void install(QObject *object, int counter);
+        QString path(int counter) const;
+        qreal sample(Counter &counter);
+};
+
+#endif // WAKEUPCOUNTER_H
@@ -0,0 +1,144 @@
+#include "windowsession.h"
+
+#include <QCoreApplication>
+#include <QSettings>
+
+WindowSession::WindowSession(QObject *parent) :
+    QObject(parent),
+    loaded(false),
+    dirty(false),
+    persistent(true)
+{
+    connect(QCoreApplication::instance(), SIGNAL(aboutToQuit()), this, SLOT(flush()));
+}
+
+WindowSession *WindowSession::instance()
+{
+    static WindowSession *session = new WindowSession(QCoreApplication::instance());
+    return session;
+}
+
+void WindowSession::load()
+{
+    if (loaded)
+        return;
+
+    loaded = true;
+
+    if (!persistent)
+        return;
+
+    QSettings settings("dialogs.ini", QSettings::IniFormat);
+
+    // single window files written before the session
+    if (settings.contains("geometry"))
+    {
+        WindowState state;
+        state.geometry = settings.value("geometry").toRect();
+        state.maximized = settings.value("maximized").toBool();
+        states.insert("main", state);
+        order.append("main");
+    }
+
+    settings.beginGroup("windows");
+    QStringList ids = settings.value("order").toStringList();
+
+    for (int i = 0; i < ids.size(); ++i)
+    {
+        settings.beginGroup(ids.at(i));
+
+        WindowState state;
+        state.geometry = settings.value("geometry").toRect();
+        state.maximized = settings.value("maximized").toBool();
+        state.customMode = settings.value("customMode").toBool();
+
+        settings.endGroup();
+
+        if (!states.contains(ids.at(i)))
+            order.append(ids.at(i));
+        states.insert(ids.at(i), state);
+    }
+
+    settings.endGroup();
+}
+
+QString WindowSession::registerWindow(const QString &windowId)
+{
+    load();
+
+    QString id = windowId;
+    for (int i = 2; openWindows.contains(id); ++i)
+        id = windowId + "_" + QString::number(i);
+
+    openWindows.insert(id);
+    return id;
+}
+
+void WindowSession::unregisterWindow(const QString &windowId)
+{
+    openWindows.remove(windowId);
+
+    if (openWindows.isEmpty())
+        flush();
+}
+
+bool WindowSession::contains(const QString &windowId) const
+{
+    return states.contains(windowId);
+}
+
+WindowSession::WindowState WindowSession::state(const QString &windowId) const
+{
+    return states.value(windowId);
+}
+
+void WindowSession::setState(const QString &windowId, const WindowState &state)
+{
+    if (!states.contains(windowId))
+        order.append(windowId);
+
+    states.insert(windowId, state);
+    dirty = true;
+}
+
+QStringList WindowSession::windowIds()
+{
+    load();
+    return order;
+}
+
+void WindowSession::setPersistent(bool persistent)
+{
+    this->persistent = persistent;
+}
+
+void WindowSession::flush()
+{
+    if (!dirty or !persistent)
+        return;
+
+    // QSettings keeps the changes in memory and writes the file once, in sync()
+    QSettings settings("dialogs.ini", QSettings::IniFormat);
+    settings.remove("geometry");
+    settings.remove("maximized");
+    settings.remove("windows");
+
+    settings.beginGroup("windows");
+    settings.setValue("order", order);
+
+    for (int i = 0; i < order.size(); ++i)
+    {
+        const WindowState &state = states[order.at(i)];
+
+        settings.beginGroup(order.at(i));
+        settings.setValue("geometry", state.geometry);
+        settings.setValue("maximized", state.maximized);
+        settings.setValue("customMode", state.customMode);
+        settings.endGroup();
+    }
+
+    settings.endGroup();
+    settings.sync();
+
+    dirty = false;
+}
@@ -0,0 +1,92 @@
+#ifndef WINDOWSESSION_H
+#define WINDOWSESSION_H
+
+#include <QObject>
+#include <QHash>
+#include <QSet>
+#include <QRect>
+#include <QStringList>
+
+/**
+ * @brief The WindowSession class keeps the state of every CustomWindow of the application in memory,
+ * keyed by a stable window id. The whole session is read from dialogs.ini once, the first time a
+ * window registers, and written back in a single batch when the last window closes or the
+ * application quits.
+ */
+class WindowSession : public QObject
+{
+    Q_OBJECT
+
+    public:
+        /**
+         * @brief The WindowState struct is the persisted state of one window.
+         */
+        struct WindowState
+        {
+            QRect geometry;
+            bool maximized;
+            bool customMode;
+
+            WindowState() : maximized(false), customMode(false) {}
+        };
+
+        /**
+         * @brief instance Returns the session of the application.
+         */
+        static WindowSession *instance();
+        /**
+         * @brief registerWindow Registers an open window. If the id is already used by an open window
+         * a numbered suffix is added, so windows created in the same order get the same ids.
+         * @param windowId The requested id.
+         * @return The id the window must use.
+         */
+        QString registerWindow(const QString &windowId);
+        /**
+         * @brief unregisterWindow Marks the window as closed, the session is flushed after the last one.
+         * @param windowId The id returned by registerWindow().
+         */
+        void unregisterWindow(const QString &windowId);
+        /**
+         * @brief contains Returns true if the session has a stored state for the window.
+         */
+        bool contains(const QString &windowId) const;
+        /**
+         * @brief state Returns the stored state of the window.
+         */
+        WindowState state(const QString &windowId) const;
+        /**
+         * @brief setState Stores the state of the window in memory.
+         */
+        void setState(const QString &windowId, const WindowState &state);
+        /**
+         * @brief windowIds Returns the ids of all the windows of the stored session.
+         */
+        QStringList windowIds();
+        /**
+         * @brief setPersistent Disables reading and writing dialogs.ini, the session is then only
+         * kept in memory. Must be called before the first window registers.
+         */
+        void setPersistent(bool persistent);
+
+    public slots:
+        /**
+         * @brief flush Writes the state of all the windows to dialogs.ini in one batch.
+         */
+        void flush();
+
+    private:
+        explicit WindowSession(QObject *parent = 0);
+        /**
+         * @brief load Reads the stored session, only once.
+         */
+        void load();
+
+        QHash<QString, WindowState> states;
+        QStringList order;
+        QSet<QString> openWindows;
+        bool loaded;
+        bool dirty;
+        bool persistent;
+};
+
+#endif // WINDOWSESSION_H
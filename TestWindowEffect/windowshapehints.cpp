@@ -0,0 +1,76 @@
+#include "windowshapehints.h"
+
+#include <QVector>
+
+#ifdef HAVE_X11_SHAPE_HINTS
+#include <QX11Info>
+#include <cstdlib>
+#include <xcb/xcb.h>
+#include <xcb/shape.h>
+
+static xcb_atom_t opaqueRegionAtom(xcb_connection_t *connection)
+{
+    static xcb_atom_t atom = XCB_ATOM_NONE;
+
+    if (atom == XCB_ATOM_NONE)
+    {
+        static const char name[] = "_NET_WM_OPAQUE_REGION";
+        xcb_intern_atom_reply_t *reply =
+                xcb_intern_atom_reply(connection, xcb_intern_atom(connection, false, sizeof(name) - 1, name), 0);
+
+        if (reply)
+        {
+            atom = reply->atom;
+            free(reply);
+        }
+    }
+
+    return atom;
+}
+
+static QRect toDevicePixels(const QRect &rect, qreal dpr)
+{
+    return QRect(qRound(rect.x() * dpr), qRound(rect.y() * dpr),
+                 qRound(rect.width() * dpr), qRound(rect.height() * dpr));
+}
+#endif
+
+void setWindowShapeHints(QWidget *window, const QRegion &opaque, const QRegion &input)
+{
+#ifdef HAVE_X11_SHAPE_HINTS
+    if (!QX11Info::isPlatformX11() or !window->isWindow() or !window->internalWinId())
+        return;
+
+    xcb_connection_t *connection = QX11Info::connection();
+    xcb_window_t id = xcb_window_t(window->internalWinId());
+    qreal dpr = window->devicePixelRatioF();
+
+    QVector<quint32> opaqueData;
+    for (QRegion::const_iterator it = opaque.begin(); it != opaque.end(); ++it)
+    {
+        QRect rect = toDevicePixels(*it, dpr);
+        opaqueData << quint32(rect.x()) << quint32(rect.y()) << quint32(rect.width()) << quint32(rect.height());
+    }
+
+    xcb_atom_t atom = opaqueRegionAtom(connection);
+    if (atom != XCB_ATOM_NONE)
+        xcb_change_property(connection, XCB_PROP_MODE_REPLACE, id, atom, XCB_ATOM_CARDINAL, 32,
+                            opaqueData.size(), opaqueData.constData());
+
+    QVector<xcb_rectangle_t> inputRects;
+    for (QRegion::const_iterator it = input.begin(); it != input.end(); ++it)
+    {
+        QRect rect = toDevicePixels(*it, dpr);
+        xcb_rectangle_t xrect = { qint16(rect.x()), qint16(rect.y()), quint16(rect.width()), quint16(rect.height()) };
+        inputRects.append(xrect);
+    }
+
+    xcb_shape_rectangles(connection, XCB_SHAPE_SO_SET, XCB_SHAPE_SK_INPUT, XCB_CLIP_ORDERING_UNSORTED,
+                         id, 0, 0, inputRects.size(), inputRects.constData());
+    xcb_flush(connection);
+#else
+    Q_UNUSED(window);
+    Q_UNUSED(opaque);
+    Q_UNUSED(input);
+#endif
+}
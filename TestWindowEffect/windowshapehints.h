@@ -0,0 +1,17 @@
+#ifndef WINDOWSHAPEHINTS_H
+#define WINDOWSHAPEHINTS_H
+
+#include <QWidget>
+#include <QRegion>
+
+/**
+ * @brief setWindowShapeHints Tells the window manager which part of a translucent top level window
+ * is opaque, so the compositor does not blend it, and which part takes mouse input. Only X11
+ * (_NET_WM_OPAQUE_REGION and the XShape input region) is supported, elsewhere this does nothing.
+ * @param window The top level window, in logical coordinates.
+ * @param opaque The fully opaque part of the window.
+ * @param input The part of the window that receives mouse input.
+ */
+void setWindowShapeHints(QWidget *window, const QRegion &opaque, const QRegion &input);
+
+#endif // WINDOWSHAPEHINTS_H
@@ -0,0 +1,9 @@
+# Builds the application and its tests, run the tests with make check
+
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    TestWindowEffect \
+    tests
+
+tests.subdir = TestWindowEffect/tests